@@ -1,74 +1,210 @@
+/**
+ * Context switch microbenchmarks for every threading backend built in
+ * (fcontext, ucontext, pth) across a range of stack sizes:
+ *   start_complete       start a context and run it to completion on one reused stack
+ *   start_complete_cold  same, cycling through enough stacks that none stay in cache
+ *   start_complete_tls   same as start_complete plus the TLS registration
+ *                        the OS does for every thread it starts
+ *   spawn_join_fresh     start/complete with a newly cloned context each time
+ *   switch_hot           resume/pause round trips with a single subthread
+ *   switch_cold          round trips cycling through many subthreads
+ *   switch_tls           round trips where the subthread reads its TLS each time
+ *
+ * Results are printed as CSV, one row per backend/test/stack size:
+ *   backend,test,stack_bytes,ops,seconds,ns_per_op
+ *
+ * Build with the Makefile here and run as
+ *   ./run --benchmark context_switch
+ */
+
 #include <sstmac/main/sstmac.h>
 #include <vector>
+#include <cstdio>
 #include <sstmac/software/threading/threading_interface.h>
-#include <sprockit/sim_parameters.h>
 #include <sstmac/software/threading/stack_alloc.h>
-#include <sprockit/keyword_registration.h>
+#include <sstmac/software/process/thread_info.h>
+#include <sstmac/software/process/global.h>
+#include <sprockit/sim_parameters.h>
 
-RegisterKeywords(
-{ "context", "the name of the context switch library to profile" },
-{ "nthread", "the number of distinct threads to context switch amongst" },
-{ "niter", "the number of context switch iterations to run" },
-);
+using sstmac::sw::ThreadContext;
+using sstmac::sw::StackAlloc;
+using sstmac::ThreadInfo;
 
 struct subthread_args {
-  sstmac::sw::ThreadContext* subthread;
-  sstmac::sw::ThreadContext* main_thread;
+  ThreadContext* subthread;
+  ThreadContext* main_thread;
+  int ntls_reads;
 };
 
 class context_switch_benchmark : public sstmac::Benchmark
 {
  public:
-  FactoryRegister("context_switch", sstmac::benchmark, context_switch_benchmark);
-
-  context_switch_benchmark(SST::Params& params){
-    main_thread_ = sstmac::sw::ThreadContext::factory
-                    ::get_param("context", params);
-    nthread_ = params.find<int>("nthread");
-    niter_ = params.find<int>("niter");
-    sstmac::sw::StackAlloc::init(params);
-  }
+  SST_ELI_REGISTER_DERIVED(
+    sstmac::Benchmark,
+    context_switch_benchmark,
+    "macro",
+    "context_switch",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "times context start/complete and switches for each threading backend")
 
   void run() override;
 
  private:
-  std::vector<subthread_args> subthreads_;
-  sstmac::sw::ThreadContext* main_thread_;
-  int nthread_;
-  int niter_;
+  void report(const char* test, int nops, double start, double stop);
+
+  void startComplete(const char* test, int nstacks, bool register_tls, bool recycle);
+
+  void switches(const char* test, int nthread, bool read_tls);
+
+  std::string backend_;
+  ThreadContext* main_thread_;
+  size_t stack_size_;
+
+  static const int nspawn_ = 100000;
+  static const int nswitch_ = 1000000;
+  static const int ncold_ = 256;
 };
 
+static void touch_stack()
+{
+  //dirty a bit of stack, as a real thread would
+  volatile char buffer[512];
+  for (int i=0; i < sizeof(buffer); i += 64) buffer[i] = i;
+}
+
+static void run_to_completion(void* args){
+  subthread_args* sargs = (subthread_args*) args;
+  touch_stack();
+  sargs->subthread->completeContext(sargs->main_thread);
+}
+
 static void run_subthread(void* args){
   subthread_args* sargs = (subthread_args*) args;
   auto subthread = sargs->subthread;
   auto main_thread = sargs->main_thread;
+  touch_stack();
   while (1){
+    if (sargs->ntls_reads){
+      sargs->ntls_reads += ThreadInfo::currentPhysicalThreadId() + 1;
+    }
     subthread->pauseContext(main_thread);
   }
 }
 
-void context_switch_benchmark::run()
+void
+context_switch_benchmark::report(const char* test, int nops, double start, double stop)
+{
+  double elapsed = stop - start;
+  printf("%s,%s,%zu,%d,%.8f,%.2f\n", backend_.c_str(), test, stack_size_,
+         nops, elapsed, elapsed * 1e9 / nops);
+  fflush(stdout);
+}
+
+void
+context_switch_benchmark::startComplete(const char* test, int nstacks,
+                                        bool register_tls, bool recycle)
 {
-  main_thread_->initContext();
-  subthreads_.resize(nthread_);
-  for (int i=0; i < nthread_; ++i){
-    auto& args = subthreads_[i];
-    auto thr = main_thread_->copy();
-    args.subthread = thr;
+  std::vector<void*> stacks(nstacks);
+  for (auto& stack : stacks) stack = StackAlloc::alloc();
+  char* tls = register_tls ? sstmac::GlobalVariable::tlsCtx.allocateSegment(false) : nullptr;
+
+  subthread_args args;
+  args.main_thread = main_thread_;
+  args.subthread = recycle ? main_thread_->copy() : nullptr;
+  args.ntls_reads = 0;
+
+  double start = now();
+  for (int i=0; i < nspawn_; ++i){
+    void* stack = stacks[i % nstacks];
+    if (!recycle) args.subthread = main_thread_->copy();
+    if (register_tls){
+      ThreadInfo::registerUserSpaceVirtualThread(0, stack, nullptr, tls);
+    }
+    args.subthread->startContext(stack, stack_size_, run_to_completion,
+                                 &args, main_thread_);
+    if (register_tls){
+      ThreadInfo::deregisterUserSpaceVirtualThread(stack);
+    }
+    args.subthread->destroyContext();
+    if (!recycle) delete args.subthread;
+  }
+  double stop = now();
+  report(test, nspawn_, start, stop);
+
+  if (recycle) delete args.subthread;
+  for (void* stack : stacks) StackAlloc::free(stack);
+  sstmac::GlobalVariable::tlsCtx.freeSegment(tls, 0);
+}
+
+void
+context_switch_benchmark::switches(const char* test, int nthread, bool read_tls)
+{
+  std::vector<subthread_args> subthreads(nthread);
+  std::vector<void*> stacks(nthread);
+  for (int i=0; i < nthread; ++i){
+    auto& args = subthreads[i];
+    args.subthread = main_thread_->copy();
     args.main_thread = main_thread_;
-    thr->startContext(0, sstmac::sw::StackAlloc::alloc(),
-             sstmac::sw::StackAlloc::stacksize(),
-             run_subthread, &args, nullptr, nullptr, main_thread_);
+    args.ntls_reads = read_tls ? 1 : 0;
+    stacks[i] = StackAlloc::alloc();
+    if (read_tls){
+      ThreadInfo::registerUserSpaceVirtualThread(i, stacks[i], nullptr, nullptr);
+    }
+    args.subthread->startContext(stacks[i], stack_size_, run_subthread,
+                                 &args, main_thread_);
   }
 
+  int niter = nswitch_ / nthread;
   double start = now();
-  for (int i=0; i < niter_; ++i){
-    for (int j=0; j < nthread_; ++j){
-      sstmac::sw::ThreadContext* subthread = subthreads_[j].subthread;
-      subthread->resumeContext(main_thread_);
+  for (int i=0; i < niter; ++i){
+    for (int j=0; j < nthread; ++j){
+      subthreads[j].subthread->resumeContext(main_thread_);
     }
   }
   double stop = now();
-  printf("Benchmark ran for %12.8fs\n", stop - start);
+  report(test, niter*nthread, start, stop);
+
+  //the subthreads never complete - just drop them
+  for (int i=0; i < nthread; ++i){
+    subthreads[i].subthread->destroyContext();
+    delete subthreads[i].subthread;
+    if (read_tls) ThreadInfo::deregisterUserSpaceVirtualThread(stacks[i]);
+    StackAlloc::free(stacks[i]);
+  }
 }
 
+void
+context_switch_benchmark::run()
+{
+  const char* backends[] = { "fcontext", "ucontext", "pth" };
+  const char* stack_sizes[] = { "16384B", "65536B", "262144B", "1048576B" };
+
+  printf("backend,test,stack_bytes,ops,seconds,ns_per_op\n");
+  for (const char* backend : backends){
+    if (!ThreadContext::getBuilderLibrary("macro")->getBuilder(backend)){
+      continue; //not built in
+    }
+    backend_ = backend;
+    for (const char* size : stack_sizes){
+      SST::Params params;
+      params.insert("stack_size", size);
+      StackAlloc::clear();
+      StackAlloc::init(params);
+      stack_size_ = StackAlloc::stacksize();
+
+      main_thread_ = sprockit::create<ThreadContext>("macro", backend_);
+      main_thread_->initContext();
+
+      startComplete("start_complete", 1, false, true);
+      startComplete("start_complete_cold", ncold_, false, true);
+      startComplete("start_complete_tls", 1, true, true);
+      startComplete("spawn_join_fresh", 1, false, false);
+      switches("switch_hot", 1, false);
+      switches("switch_cold", ncold_, false);
+      switches("switch_tls", 1, true);
+
+      main_thread_->destroyContext();
+      delete main_thread_;
+    }
+  }
+}
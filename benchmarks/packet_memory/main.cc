@@ -0,0 +1,73 @@
+/**
+ * Reports the memory cost of an in-flight pisces or sculpin packet:
+ * the object size and the resident bytes per packet measured by
+ * holding a large number of packets live at once.
+ *
+ * Build with the Makefile here and run as
+ *   ./run --benchmark packet_memory
+ */
+
+#include <sstmac/main/sstmac.h>
+#include <sstmac/hardware/pisces/pisces.h>
+#include <sstmac/hardware/sculpin/sculpin.h>
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+
+class packet_memory_benchmark : public sstmac::Benchmark
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    sstmac::Benchmark,
+    packet_memory_benchmark,
+    "macro",
+    "packet_memory",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "measures bytes per in-flight pisces/sculpin packet")
+
+  void run() override;
+
+ private:
+  static long residentBytes();
+
+  template <class T, class Fxn>
+  void measure(const char* name, Fxn&& fxn);
+};
+
+long
+packet_memory_benchmark::residentBytes()
+{
+  long size, resident;
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (!f) return 0;
+  if (fscanf(f, "%ld %ld", &size, &resident) != 2) resident = 0;
+  fclose(f);
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+template <class T, class Fxn>
+void
+packet_memory_benchmark::measure(const char* name, Fxn&& fxn)
+{
+  static const int npackets = 1 << 21;
+  std::vector<T*> packets(npackets);
+  long before = residentBytes();
+  for (int i=0; i < npackets; ++i){
+    packets[i] = fxn(i);
+  }
+  long after = residentBytes();
+  printf("%-8s sizeof=%4zu resident/packet=%8.2f\n", name, sizeof(T),
+         double(after - before) / npackets);
+  for (T* pkt : packets) delete pkt;
+}
+
+void
+packet_memory_benchmark::run()
+{
+  measure<sstmac::hw::PiscesPacket>("pisces", [](int i){
+    return new sstmac::hw::PiscesPacket(nullptr, 1024, i, false, 0, 1);
+  });
+  measure<sstmac::hw::SculpinPacket>("sculpin", [](int i){
+    return new sstmac::hw::SculpinPacket(nullptr, 1024, false, i, 1, 0);
+  });
+}
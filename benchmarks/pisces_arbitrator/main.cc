@@ -0,0 +1,323 @@
+/**
+ * Compares the arbitration throughput of the cut_through arbitrator
+ * against the original linked-list epoch implementation (kept here as
+ * a reference). Both are driven with the same randomized packet stream
+ * and must produce identical head/tail departure times.
+ * A second, lightly loaded stream checks that the idle-link fast path
+ * gives the same departure times as the full model.
+ *
+ * Build with the Makefile here and run as
+ *   ./run --benchmark pisces_arbitrator
+ */
+
+#include <sstmac/main/sstmac.h>
+#include <sstmac/hardware/pisces/pisces_arbitrator.h>
+#include <sprockit/errors.h>
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <cstdio>
+
+using sstmac::Timestamp;
+using sstmac::GlobalTimestamp;
+using sstmac::hw::PiscesPacket;
+using sstmac::hw::PiscesBandwidthArbitrator;
+
+/**
+ * The cut-through arbitrator as it was before epochs moved into a
+ * contiguous buffer: one thread_safe_new allocation per epoch.
+ */
+class ListCutThroughArbitrator : public PiscesBandwidthArbitrator
+{
+ public:
+  ListCutThroughArbitrator(double bw) : PiscesBandwidthArbitrator(bw)
+  {
+    cycleLength_ = byteDelay_;
+    head_ = new Epoch;
+    head_->next = nullptr;
+    head_->numCycles = std::numeric_limits<uint32_t>::max();
+  }
+
+  ~ListCutThroughArbitrator(){
+    while (head_){
+      Epoch* next = head_->next;
+      delete head_;
+      head_ = next;
+    }
+  }
+
+  std::string toString() const override {
+    return "list cut through arbitrator";
+  }
+
+  Timestamp headTailDelay(PiscesPacket *pkt) override {
+    return pkt->numBytes() * pkt->byteDelay();
+  }
+
+  void arbitrate(IncomingPacket &st) override;
+
+ private:
+  struct Epoch : public sprockit::thread_safe_new<Epoch> {
+    GlobalTimestamp start;
+    uint32_t numCycles;
+    Epoch* next;
+  };
+
+  Epoch* advance(Epoch* epoch, Epoch* prev){
+    Epoch* next = epoch->next;
+    if (prev) prev->next = epoch->next;
+    else head_ = next;
+    delete epoch;
+    return next;
+  }
+
+  void clearOut(GlobalTimestamp now);
+
+  Epoch* head_;
+  Timestamp cycleLength_;
+};
+
+void
+ListCutThroughArbitrator::clearOut(GlobalTimestamp now)
+{
+  Epoch* epoch = head_;
+  while (epoch){
+    GlobalTimestamp end = epoch->start + epoch->numCycles * cycleLength_;
+    if (now <= epoch->start){
+      return;
+    } else if (now < end){
+      if (epoch->next){
+        Timestamp lostTime = now - epoch->start;
+        uint32_t lostCycles = lostTime / cycleLength_;
+        epoch->numCycles -= lostCycles;
+      } else {
+        epoch->numCycles = std::numeric_limits<uint32_t>::max();
+      }
+      epoch->start = now;
+      return;
+    } else if (epoch->next){
+      Epoch* next = epoch->next;
+      delete epoch;
+      head_ = next;
+      epoch = next;
+    } else {
+      epoch->numCycles = std::numeric_limits<uint32_t>::max();
+      epoch->start = now;
+      return;
+    }
+  }
+}
+
+void
+ListCutThroughArbitrator::arbitrate(IncomingPacket &st)
+{
+  clearOut(st.now);
+
+  GlobalTimestamp fullyBufferedTime = st.now + st.pkt->byteDelay() * st.pkt->numBytes();
+  Epoch* epoch = head_;
+  Epoch* prev = nullptr;
+  uint32_t bytesSent = 0;
+  uint32_t bytesLeft = st.pkt->numBytes();
+  st.head_leaves = epoch->start;
+  while (bytesLeft > 2){
+    Timestamp epochLength = epoch->numCycles * cycleLength_;
+    GlobalTimestamp epochEnd = epoch->start + epochLength;
+    if (st.pkt->byteDelay() <= cycleLength_){
+      if (epoch->numCycles <= bytesLeft){
+        bytesSent += epoch->numCycles;
+        bytesLeft -= epoch->numCycles;
+        epoch = advance(epoch, prev);
+        st.tail_leaves = epochEnd;
+      } else {
+        epoch->start += bytesLeft * cycleLength_;
+        epoch->numCycles -= bytesLeft;
+        st.tail_leaves = epoch->start;
+        bytesLeft = 0;
+        bytesSent = st.pkt->numBytes();
+      }
+    } else {
+      if (fullyBufferedTime >= epochEnd){
+        uint32_t bytesArrived = (epochEnd - st.now) / st.pkt->byteDelay();
+        uint32_t bytesBuffered = std::min(bytesLeft, bytesArrived - bytesSent);
+        if (bytesBuffered >= epoch->numCycles){
+          bytesSent += epoch->numCycles;
+          bytesLeft -= epoch->numCycles;
+          epoch = advance(epoch, prev);
+        } else {
+          epoch->numCycles -= bytesBuffered;
+          prev = epoch;
+          epoch = epoch->next;
+          bytesSent += bytesBuffered;
+          bytesLeft -= bytesBuffered;
+        }
+        st.tail_leaves = epochEnd;
+      } else if (fullyBufferedTime <= epoch->start) {
+        if (epoch->numCycles > bytesLeft){
+          epoch->numCycles -= bytesLeft;
+          epoch->start += bytesLeft * cycleLength_;
+          st.tail_leaves = epoch->start;
+          bytesLeft = 0;
+          bytesSent = st.pkt->numBytes();
+        } else {
+          bytesLeft -= epoch->numCycles;
+          bytesSent += epoch->numCycles;
+          epoch = advance(epoch, prev);
+          st.tail_leaves = epochEnd;
+        }
+      } else {
+        Epoch* next = new Epoch;
+        Timestamp deltaT = fullyBufferedTime - epoch->start;
+        uint32_t preCycles = deltaT  / cycleLength_;
+        uint32_t postCycles = epoch->numCycles - preCycles;
+        epoch->numCycles = preCycles;
+        if (epoch->next){
+          next->next = epoch->next;
+          next->numCycles = postCycles;
+        } else {
+          next->next = nullptr;
+          next->numCycles = std::numeric_limits<uint32_t>::max();
+        }
+        next->start = epoch->start + deltaT;
+        epoch->next = next;
+      }
+    }
+  }
+
+  Timestamp newByteDelay = (st.tail_leaves - st.head_leaves) / st.pkt->numBytes();
+  st.pkt->setByteDelay(newByteDelay);
+}
+
+class pisces_arbitrator_benchmark : public sstmac::Benchmark
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    sstmac::Benchmark,
+    pisces_arbitrator_benchmark,
+    "macro",
+    "pisces_arbitrator",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "compares cut-through arbitrator throughput against the linked-list version")
+
+  void run() override;
+
+ private:
+  struct Arrival {
+    GlobalTimestamp now;
+    Timestamp byte_delay;
+    int size_index;
+  };
+
+  double time(PiscesBandwidthArbitrator* arb, const std::vector<Arrival>& arrivals,
+              std::vector<GlobalTimestamp>& tails, bool idle_fast_path = false);
+
+  void compare(const char* name_a, const std::vector<GlobalTimestamp>& a,
+               const char* name_b, const std::vector<GlobalTimestamp>& b);
+
+  std::vector<Arrival> makeArrivals(int npackets, double link_bw, double load);
+
+  //one packet per distinct size, reused across arrivals
+  std::vector<PiscesPacket*> packets_;
+};
+
+double
+pisces_arbitrator_benchmark::time(PiscesBandwidthArbitrator* arb,
+                                  const std::vector<Arrival>& arrivals,
+                                  std::vector<GlobalTimestamp>& tails,
+                                  bool idle_fast_path)
+{
+  PiscesBandwidthArbitrator::IncomingPacket st;
+  tails.resize(arrivals.size());
+  double start = now();
+  for (int i=0; i < arrivals.size(); ++i){
+    const Arrival& a = arrivals[i];
+    st.pkt = packets_[a.size_index];
+    st.pkt->setByteDelay(a.byte_delay);
+    st.now = a.now;
+    if (!idle_fast_path || !arb->arbitrateIdle(st)){
+      arb->arbitrate(st);
+    }
+    tails[i] = st.tail_leaves;
+  }
+  double stop = now();
+  return stop - start;
+}
+
+void
+pisces_arbitrator_benchmark::compare(
+  const char* name_a, const std::vector<GlobalTimestamp>& a,
+  const char* name_b, const std::vector<GlobalTimestamp>& b)
+{
+  for (int i=0; i < a.size(); ++i){
+    if (a[i] != b[i]){
+      spkt_abort_printf("%s and %s disagree on packet %d: %12.8e != %12.8e",
+                        name_a, name_b, i, a[i].sec(), b[i].sec());
+    }
+  }
+}
+
+std::vector<pisces_arbitrator_benchmark::Arrival>
+pisces_arbitrator_benchmark::makeArrivals(int npackets, double link_bw, double load)
+{
+  //a bursty stream with a mix of packets arriving faster and slower than
+  //the link, the mean gap between packets is scaled to give the load
+  srand(42);
+  std::vector<Arrival> arrivals(npackets);
+  double t = 0;
+  for (auto& a : arrivals){
+    a.size_index = rand() % packets_.size();
+    uint32_t num_bytes = packets_[a.size_index]->numBytes();
+    double arrival_bw = link_bw * (0.25 + (rand() % 8) * 0.25);
+    a.byte_delay = Timestamp(1.0/arrival_bw);
+    a.now = GlobalTimestamp(t);
+    t += num_bytes / link_bw * (0.25 + (rand() % 8) * 0.25) / load;
+  }
+  return arrivals;
+}
+
+void
+pisces_arbitrator_benchmark::run()
+{
+  static const int npackets = 2000000;
+  static const double link_bw = 10e9;
+  static const uint32_t mtu = 4096;
+  static const int nsizes = 64;
+
+  for (int i=1; i <= nsizes; ++i){
+    packets_.push_back(new PiscesPacket(nullptr, i*mtu/nsizes, 0, false, 0, 1));
+  }
+
+  //keep the link around full load
+  std::vector<Arrival> arrivals = makeArrivals(npackets, link_bw, 1.0);
+
+  auto* ring = sprockit::create<PiscesBandwidthArbitrator>("macro", "cut_through", link_bw);
+  auto* list = new ListCutThroughArbitrator(link_bw);
+
+  std::vector<GlobalTimestamp> ring_tails, list_tails;
+  double list_t = time(list, arrivals, list_tails);
+  double ring_t = time(ring, arrivals, ring_tails);
+  compare("linked list", list_tails, "epoch buffer", ring_tails);
+
+  printf("linked list:   %12.8fs %10.2f Mpkt/s\n", list_t, npackets / list_t / 1e6);
+  printf("epoch buffer:  %12.8fs %10.2f Mpkt/s\n", ring_t, npackets / ring_t / 1e6);
+  printf("speedup:       %12.4f\n", list_t / ring_t);
+
+  delete ring;
+  delete list;
+
+  //a lightly loaded link, where most packets see an idle link
+  arrivals = makeArrivals(npackets, link_bw, 0.2);
+  auto* full = sprockit::create<PiscesBandwidthArbitrator>("macro", "cut_through", link_bw);
+  auto* fast = sprockit::create<PiscesBandwidthArbitrator>("macro", "cut_through", link_bw);
+  std::vector<GlobalTimestamp> full_tails, fast_tails;
+  double full_t = time(full, arrivals, full_tails);
+  double fast_t = time(fast, arrivals, fast_tails, true);
+  compare("full model", full_tails, "idle fast path", fast_tails);
+
+  printf("low load full: %12.8fs %10.2f Mpkt/s\n", full_t, npackets / full_t / 1e6);
+  printf("low load fast: %12.8fs %10.2f Mpkt/s\n", fast_t, npackets / fast_t / 1e6);
+  printf("speedup:       %12.4f\n", full_t / fast_t);
+
+  delete full;
+  delete fast;
+  for (auto* pkt : packets_) delete pkt;
+}
@@ -1119,6 +1119,10 @@ struct PragmaActivateGuard {
         prg->activate(t, rewriter_, pragmaConfig_);
       }
     }
+    if (pragmaConfig_.keepStmt){
+      skipVisit_ = false;
+      pragmaConfig_.keepStmt = false;
+    }
   }
 
   void init();
@@ -49,6 +49,9 @@ Questions? Contact sst-macro-help@sandia.gov
 #include "computeLoops.h"
 #include "replacements.h"
 #include "validateScope.h"
+#include <cctype>
+#include <cstring>
+#include <set>
 #include <sstream>
 
 using namespace clang;
@@ -161,6 +164,134 @@ SSTComputePragma::visitForStmt(ForStmt *stmt, Rewriter &r, PragmaConfig& cfg)
   replaceForStmt(stmt, *CI, *pragmaList, r, cfg, cfg.astVisitor, nthread_);
 }
 
+static bool
+hasPrefix(const std::string& name, const char* prefix)
+{
+  return name.compare(0, strlen(prefix), prefix) == 0;
+}
+
+/**
+ * MPI calls that move data or synchronize ranks, named without the
+ * MPI_, PMPI_, SSTMAC_MPI_ or sstmac_ prefix the skeleton headers give them.
+ * Local calls like MPI_Comm_rank or MPI_Type_commit are left out.
+ */
+static const std::set<std::string> mpiCommCalls = {
+  "init", "init_thread", "finalize", "abort",
+  "send", "bsend", "ssend", "rsend", "isend", "ibsend", "issend", "irsend",
+  "send_init", "bsend_init", "ssend_init", "rsend_init",
+  "recv", "irecv", "recv_init", "sendrecv", "sendrecv_replace",
+  "probe", "iprobe", "mprobe", "improbe", "mrecv", "imrecv",
+  "start", "startall",
+  "wait", "waitall", "waitany", "waitsome",
+  "test", "testall", "testany", "testsome",
+  "barrier", "ibarrier", "bcast", "ibcast",
+  "gather", "gatherv", "igather", "igatherv",
+  "scatter", "scatterv", "iscatter", "iscatterv",
+  "allgather", "allgatherv", "iallgather", "iallgatherv",
+  "alltoall", "alltoallv", "alltoallw", "ialltoall", "ialltoallv", "ialltoallw",
+  "reduce", "ireduce", "allreduce", "iallreduce",
+  "reduce_scatter", "ireduce_scatter", "reduce_scatter_block", "ireduce_scatter_block",
+  "scan", "iscan", "exscan", "iexscan",
+  "comm_split", "comm_dup", "comm_create", "comm_create_group", "cart_create",
+  "put", "get", "mpi_put", "mpi_get", "accumulate", "get_accumulate",
+  "fetch_and_op", "compare_and_swap",
+  "win_create", "win_free", "win_fence", "win_lock", "win_unlock",
+  "win_lock_all", "win_unlock_all", "win_flush", "win_flush_local", "win_flush_all",
+  "win_start", "win_complete", "win_post", "win_wait"
+};
+
+/**
+ * OpenSHMEM calls that move data or synchronize PEs, named without the
+ * shmem_ prefix and without the type in typed calls like shmem_int_put
+ */
+static const std::set<std::string> shmemCommCalls = {
+  "put", "get", "p", "g", "iput", "iget", "put_nbi", "get_nbi",
+  "putmem", "getmem", "put32", "put64", "put128", "get32", "get64", "get128",
+  "barrier", "barrier_all", "fence", "quiet", "wait", "wait_until",
+  "broadcast32", "broadcast64", "collect32", "collect64",
+  "fcollect32", "fcollect64", "alltoall32", "alltoall64",
+  "sum_to_all", "prod_to_all", "min_to_all", "max_to_all",
+  "and_to_all", "or_to_all", "xor_to_all",
+  "swap", "cswap", "fadd", "finc", "add", "inc", "fetch", "set",
+  "atomic_fetch", "atomic_set", "atomic_swap", "atomic_compare_swap",
+  "atomic_fetch_add", "atomic_fetch_inc", "atomic_add", "atomic_inc",
+  "set_lock", "clear_lock", "test_lock"
+};
+
+static bool
+isCommunication(const std::string& name)
+{
+  //longest prefix first, PMPI_ and SSTMAC_MPI_ also end in MPI_
+  static const char* mpiPrefixes[] = { "SSTMAC_MPI_", "PMPI_", "MPI_", "sstmac_" };
+  for (const char* prefix : mpiPrefixes){
+    if (hasPrefix(name, prefix)){
+      std::string call = name.substr(strlen(prefix));
+      for (char& c : call) c = tolower(c);
+      return mpiCommCalls.count(call);
+    }
+  }
+
+  if (hasPrefix(name, "shmem_")){
+    std::string call = name.substr(strlen("shmem_"));
+    if (shmemCommCalls.count(call)) return true;
+    std::size_t typeEnd = call.find('_');
+    return typeEnd != std::string::npos && shmemCommCalls.count(call.substr(typeEnd + 1));
+  }
+  return false;
+}
+
+static bool
+containsCommunication(Stmt* stmt, std::set<const FunctionDecl*>& visited)
+{
+  if (!stmt) return false;
+
+  if (auto call = dyn_cast<CallExpr>(stmt)){
+    FunctionDecl* callee = call->getDirectCallee();
+    if (callee){
+      if (isCommunication(callee->getNameAsString())) return true;
+      FunctionDecl* def = callee->getDefinition();
+      if (def && visited.insert(def).second
+          && containsCommunication(def->getBody(), visited)){
+        return true;
+      }
+    }
+  }
+
+  for (Stmt* child : stmt->children()){
+    if (containsCommunication(child, visited)) return true;
+  }
+  return false;
+}
+
+void
+SSTOpenMPParallelPragma::activate(Stmt *stmt, Rewriter &r, PragmaConfig& cfg)
+{
+  std::set<const FunctionDecl*> visited;
+  if (containsCommunication(stmt, visited)){
+    //no analytic model for a region that communicates - the original code
+    //stays in place and runs on the calling thread
+    warn(stmt, *CI,
+         "omp parallel region contains communication and will not be skeletonized");
+    cfg.keepStmt = true;
+    cfg.computeMemorySpec = "";
+    return;
+  }
+
+  if (parallelFor_ && stmt->getStmtClass() == Stmt::ForStmtClass){
+    ForStmt* fs = cast<ForStmt>(stmt);
+    cfg.astVisitor->appendComputeLoop(fs);
+    ComputeVisitor vis(*CI, *pragmaList, nullptr, cfg.astVisitor);
+    Loop loop(0);
+    vis.setContext(fs);
+    vis.visitLoop(fs, loop);
+    vis.replaceParallelFor(fs, r, loop, cfg, nthread_, schedule_, chunk_);
+    cfg.astVisitor->popComputeLoop();
+    cfg.computeMemorySpec = "";
+  } else {
+    SSTComputePragma::activate(stmt, r, cfg);
+  }
+}
+
 void
 SSTMemoizeComputePragma::doReplace(SourceLocation startInsert, SourceLocation finalInsert, Stmt* fullStmt,
                                    bool insertStartAfter, bool insertFinalAfter,
@@ -423,6 +554,8 @@ SSTMemoryPragmaHandler::handleSSTPragma(const std::list<Token> &tokens) const
 
 enum OpenMPProperty {
   OMP_NTHREAD,
+  OMP_SCHEDULE_KIND,
+  OMP_SCHEDULE_CHUNK,
   OMP_NONE
 };
 
@@ -431,15 +564,49 @@ SSTOpenMPParallelPragmaHandler::handleSSTPragma(const std::list<Token> &tokens)
 {
   static const std::map<std::string, OpenMPProperty> omp_property_map = {
     {"num_threads", OMP_NTHREAD},
+    {"schedule", OMP_SCHEDULE_KIND},
+  };
+
+  static const std::map<std::string, std::string> omp_schedule_map = {
+    {"static", "SSTMAC_OMP_SCHED_STATIC"},
+    {"dynamic", "SSTMAC_OMP_SCHED_DYNAMIC"},
+    {"guided", "SSTMAC_OMP_SCHED_GUIDED"},
+    {"auto", "SSTMAC_OMP_SCHED_AUTO"},
+    {"runtime", "SSTMAC_OMP_SCHED_AUTO"},
   };
 
   std::string nthread;
+  bool parallelFor = false;
+  std::string schedule = "SSTMAC_OMP_SCHED_STATIC";
+  std::list<Token> chunk;
+  int chunkParens = 0;
   OpenMPProperty activeProp = OMP_NONE;
   for (const Token& t : tokens){
+    if (activeProp == OMP_SCHEDULE_CHUNK){
+      //the chunk size can be any expression up to the closing paren
+      if (t.is(tok::l_paren)){
+        ++chunkParens;
+      } else if (t.is(tok::r_paren) && chunkParens-- == 0){
+        activeProp = OMP_NONE;
+        continue;
+      }
+      chunk.push_back(t);
+      continue;
+    }
+
     switch (t.getKind()){
+    case tok::kw_for:
+      parallelFor = true;
+      break;
+    case tok::kw_static:
+    case tok::kw_auto:
     case tok::identifier:
     {
-      auto next = t.getIdentifierInfo()->getName().str();
+      //static and auto lex as keywords, but are just schedule kinds here
+      std::string next;
+      if (t.is(tok::kw_static)) next = "static";
+      else if (t.is(tok::kw_auto)) next = "auto";
+      else next = t.getIdentifierInfo()->getName().str();
       switch (activeProp) {
       case OMP_NONE:
       {
@@ -455,9 +622,30 @@ SSTOpenMPParallelPragmaHandler::handleSSTPragma(const std::list<Token> &tokens)
         activeProp = OMP_NONE;
         break;
       }
+      case OMP_SCHEDULE_KIND:
+      {
+        //skip modifiers like monotonic until we hit the kind
+        auto iter = omp_schedule_map.find(next);
+        if (iter != omp_schedule_map.end()){
+          schedule = iter->second;
+        }
+        break;
+      }
+      case OMP_SCHEDULE_CHUNK:
+        break;
       }
       break;
     }
+    case tok::comma:
+      if (activeProp == OMP_SCHEDULE_KIND){
+        activeProp = OMP_SCHEDULE_CHUNK;
+      }
+      break;
+    case tok::r_paren:
+      if (activeProp == OMP_SCHEDULE_KIND){
+        activeProp = OMP_NONE;
+      }
+      break;
     case tok::string_literal:
     case tok::numeric_constant:
     {
@@ -468,7 +656,7 @@ SSTOpenMPParallelPragmaHandler::handleSSTPragma(const std::list<Token> &tokens)
         activeProp = OMP_NONE;
         break;
       }
-      case OMP_NONE:
+      default:
         break;
       }
     }
@@ -477,7 +665,14 @@ SSTOpenMPParallelPragmaHandler::handleSSTPragma(const std::list<Token> &tokens)
   } //end switch
   } //end for
 
-  return new SSTComputePragma(nthread);
+  std::string chunkStr = "0";
+  if (!chunk.empty()){
+    std::stringstream sstr;
+    SSTPragma::tokenStreamToString(chunk.begin(), chunk.end(), sstr, ci_);
+    chunkStr = "(" + sstr.str() + ")";
+  }
+
+  return new SSTOpenMPParallelPragma(nthread, parallelFor, schedule, chunkStr);
 }
 
 SSTPragma*
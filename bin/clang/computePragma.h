@@ -59,9 +59,11 @@ class SSTComputePragma : public SSTPragma {
                              PragmaConfig& cfg, SkeletonASTVisitor* visitor,
                              const std::string& nthread);
 
- private:
+ protected:
   void activate(clang::Stmt *stmt, clang::Rewriter &r, PragmaConfig& cfg) override;
   void activate(clang::Decl* decl, clang::Rewriter& r, PragmaConfig& cfg) override;
+
+ private:
   void defaultAct(clang::Stmt* stmt, clang::Rewriter &r, PragmaConfig& cfg);
   void visitForStmt(clang::ForStmt* stmt, clang::Rewriter& r, PragmaConfig& cfg);
   void visitCXXMethodDecl(clang::CXXMethodDecl* decl, clang::Rewriter& r, PragmaConfig& cfg);
@@ -69,10 +71,32 @@ class SSTComputePragma : public SSTPragma {
   void visitIfStmt(clang::IfStmt* stmt, clang::Rewriter& r, PragmaConfig& cfg);
   void visitAndReplaceStmt(clang::Stmt* stmt, clang::Rewriter& r, PragmaConfig& cfg);
 
-  std::string nthread_;
-
  protected:
   SSTComputePragma(SSTPragma::class_t cls) : SSTPragma(cls) {}
+
+  std::string nthread_;
+};
+
+/**
+ * An omp parallel region skeletonized as a compute block. A parallel for
+ * becomes a single analytic compute event priced by its schedule rather
+ * than by the loop's total work over the thread count. Regions that
+ * communicate cannot collapse into one event and are left in place.
+ */
+class SSTOpenMPParallelPragma : public SSTComputePragma
+{
+ public:
+  SSTOpenMPParallelPragma(const std::string& nthread, bool parallelFor,
+                          const std::string& schedule, const std::string& chunk) :
+    SSTComputePragma(nthread), parallelFor_(parallelFor),
+    schedule_(schedule), chunk_(chunk) {}
+
+ private:
+  void activate(clang::Stmt *stmt, clang::Rewriter &r, PragmaConfig& cfg) override;
+
+  bool parallelFor_;
+  std::string schedule_;
+  std::string chunk_;
 };
 
 class SSTAlwaysComputePragma : public SSTComputePragma
@@ -818,3 +818,20 @@ ComputeVisitor::replaceStmt(Stmt* stmt, Rewriter& r, Loop& loop, PragmaConfig& c
   replace(stmt,r,sstr.str(),CI);
 }
 
+void
+ComputeVisitor::replaceParallelFor(ForStmt* stmt, Rewriter& r, Loop& loop, PragmaConfig& cfg,
+                                   const std::string& nthread, const std::string& schedule,
+                                   const std::string& chunk)
+{
+  std::stringstream sstr;
+  sstr << "{ uint64_t flops=0; uint64_t readBytes=0; uint64_t writeBytes=0; uint64_t intops=0; ";
+  addLoopContribution(sstr, loop);
+  if (cfg.computeMemorySpec.size() != 0){
+    sstr << "readBytes=" << cfg.computeMemorySpec << ";";
+  }
+  sstr << "sstmac_omp_parallel_for((" << loop.tripCount << "),"
+       << schedule << "," << chunk << ",flops,intops,readBytes,"
+       << (nthread.empty() ? "-1" : nthread) << "); }";
+  replace(stmt,r,sstr.str(),CI);
+}
+
@@ -62,6 +62,10 @@ class ComputeVisitor  {
   void replaceStmt(clang::Stmt* stmt, clang::Rewriter& r, Loop& loop, PragmaConfig& cfg,
                    const std::string& nthread);
 
+  void replaceParallelFor(clang::ForStmt* stmt, clang::Rewriter& r, Loop& loop, PragmaConfig& cfg,
+                          const std::string& nthread, const std::string& schedule,
+                          const std::string& chunk);
+
   void setContext(clang::Stmt* stmt);
 
   void visitLoop(clang::ForStmt* stmt, Loop& loop);
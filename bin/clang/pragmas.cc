@@ -131,6 +131,9 @@ static void tokenToString(const Token& tok, std::ostream& os,
   case tok::minus:
     os << "-";
     break;
+  case tok::plus:
+    os << "+";
+    break;
   case tok::percent:
     os << "%";
     break;
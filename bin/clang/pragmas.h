@@ -59,6 +59,8 @@ struct SSTNullVariableGeneratorPragma;
 struct PragmaConfig {
   int pragmaDepth;
   bool makeNoChanges;
+  //set by a pragma on activation when it leaves its statement to be visited as usual
+  bool keepStmt;
   std::map<std::string,SSTReplacePragma*> replacePragmas;
   std::map<clang::Decl*,SSTNullVariablePragma*> nullVariables;
   std::map<clang::FunctionDecl*,std::set<SSTPragma*>> functionPragmas;
@@ -69,6 +71,7 @@ struct PragmaConfig {
   SkeletonASTVisitor* astVisitor;
   PragmaConfig() : pragmaDepth(0),
     makeNoChanges(false),
+    keepStmt(false),
     nullifyDeclarationsPragma(nullptr)
   {}
   std::string computeMemorySpec;
@@ -45,7 +45,13 @@ struct ThreadAllocatorSet {
   }
 };
 
-template <class T>
+#define SSTMAC_CACHE_ALIGNMENT 64
+/**
+ * Slab allocator for small, frequently created objects.  By default each
+ * slot is padded to a cache line.  Objects that are allocated in very large
+ * numbers (e.g. packets) can request a smaller slot alignment to save memory.
+ */
+template <class T, int Alignment = SSTMAC_CACHE_ALIGNMENT>
 class thread_safe_new {
 
  public:
@@ -121,19 +127,20 @@ class thread_safe_new {
 #endif
   }
 #endif
-#define SSTMAC_CACHE_ALIGNMENT 64
   static void grow(int thread){
+    static_assert(Alignment % alignof(T) == 0,
+                  "slot alignment must be a multiple of the type alignment");
     size_t unitSize = sizeof(T);
-    if (unitSize % SSTMAC_CACHE_ALIGNMENT != 0){
-      size_t rem = SSTMAC_CACHE_ALIGNMENT - unitSize % SSTMAC_CACHE_ALIGNMENT;
+    if (unitSize % Alignment != 0){
+      size_t rem = Alignment - unitSize % Alignment;
       unitSize += rem;
     }
 
     char* newTs = new char[unitSize*increment];
     char* ptr = newTs;
     int numElems = increment;
-    if (uintptr_t(ptr) % SSTMAC_CACHE_ALIGNMENT){
-      size_t rem = SSTMAC_CACHE_ALIGNMENT - (uintptr_t(ptr) % SSTMAC_CACHE_ALIGNMENT);
+    if (uintptr_t(ptr) % Alignment){
+      size_t rem = Alignment - (uintptr_t(ptr) % Alignment);
       ptr += rem;
       numElems -= 1;
     }
@@ -154,9 +161,9 @@ class thread_safe_new {
 #endif
 };
 
-template <class T> ThreadAllocatorSet thread_safe_new<T>::alloc_;
+template <class T, int Alignment> ThreadAllocatorSet thread_safe_new<T,Alignment>::alloc_;
 #if SPKT_NEW_SUPER_DEBUG
-template <class T> std::set<void*> thread_safe_new<T>::all_chunks_;
+template <class T, int Alignment> std::set<void*> thread_safe_new<T,Alignment>::all_chunks_;
 #endif
 
 }
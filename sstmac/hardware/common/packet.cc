@@ -57,15 +57,13 @@ Packet::Packet(
   bool is_tail,
   NodeId fromaddr,
   NodeId toaddr) :
- num_bytes_(num_bytes),
- payload_(orig),
- flow_id_(flow_id),
+ toaddr_(toaddr),
  fromaddr_(fromaddr),
- toaddr_(toaddr)
+ flow_id_(flow_id),
+ payload_(orig),
+ num_bytes_(num_bytes)
 {
   ::memset(rtr_metadata_, 0, sizeof(rtr_metadata_));
-  ::memset(stats_metadata_, 0, sizeof(stats_metadata_));
-  ::memset(nic_metadata_, 0, sizeof(nic_metadata_));
   auto hdr = rtrHeader<Header>();
   hdr->is_tail = is_tail;
 }
@@ -78,8 +76,6 @@ Packet::serialize_order(serializer& ser)
   ser & num_bytes_;
   ser & flow_id_;
   ser & rtr_metadata_;
-  ser & stats_metadata_;
-  ser & nic_metadata_;
 }
 
 }
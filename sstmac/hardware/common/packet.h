@@ -54,8 +54,8 @@ namespace hw {
 
 #define MAX_HEADER_BYTES 16
 #define MAX_CONTROL_BYTES 8
-#define MAX_NIC_BYTES 8
-#define MAX_STAT_BYTES 8
+//packets are allocated in huge numbers - don't pad each one to a cache line
+#define PACKET_SLOT_ALIGNMENT 8
 class Packet :
   public Event,
   public sprockit::printable
@@ -152,15 +152,12 @@ class Packet :
 
   uint64_t flow_id_;
 
-  uint32_t num_bytes_;
-
   serializable* payload_;
 
   char rtr_metadata_[MAX_HEADER_BYTES];
 
-  char nic_metadata_[MAX_NIC_BYTES];
-
-  char stats_metadata_[MAX_STAT_BYTES];
+  /** Kept last so subclasses can pack small fields into the tail padding */
+  uint32_t num_bytes_;
 
  protected:
   Packet() : Packet(nullptr, 0, 0, false, 0, 0) {}
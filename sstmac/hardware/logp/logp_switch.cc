@@ -62,6 +62,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/topology/topology.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/nic/nic.h>
+#include <sstmac/hardware/network/network_message.h>
 #include <sstmac/common/event_manager.h>
 #include <sprockit/util.h>
 #include <sprockit/sim_parameters.h>
@@ -148,8 +149,7 @@ LogPSwitch::send(GlobalTimestamp start, NetworkMessage* msg)
     double bw_inc = rng_->realvalue();
     delay += msg->byteLength() * bw_inc * random_max_extra_byte_delay_;
   } else if (contention_model_) {
-    double contention = contention_model_->value();
-    delay += msg->byteLength() * byte_delay_ * contention;
+    delay += contention_model_->extraDelay(start, msg, byte_delay_, hop_latency_);
   }
 
   NodeId dst = msg->toaddr();
@@ -167,6 +167,13 @@ LogPSwitch::send(GlobalTimestamp start, NetworkMessage* msg)
   nic_links_[dst]->send(extra_delay, new NicEvent(msg));
 }
 
+Timestamp
+LogPSwitch::ContentionModel::extraDelay(GlobalTimestamp start, NetworkMessage* msg,
+                                        Timestamp byte_delay, Timestamp hop_latency)
+{
+  return msg->byteLength() * byte_delay * value();
+}
+
 struct SlidingContentionModel : public LogPSwitch::ContentionModel
 {
  public:
@@ -221,6 +228,155 @@ struct SlidingContentionModel : public LogPSwitch::ContentionModel
 
 };
 
+/**
+ * Tracks when each switch output port is next free and delays a message
+ * by the time it would wait for the ports along its minimal route. The
+ * head of the message moves on after the hop latency while its bytes hold
+ * each port for the full serialization time. At each switch the message
+ * takes one of the ports that get it one hop closer according to
+ * Topology::switchDistance(), so no routers are needed. Equal-cost ports
+ * are chosen by hashing the flow, like ECMP. The minimal ports for each
+ * (switch, destination) pair are found once in O(radix) and cached, so a
+ * message costs O(hops) after that. Busy times are one flat array indexed
+ * by switch*radix + port.
+ *
+ * Each LogP switch owns its own model and there is one LogP switch per
+ * thread and per rank. In parallel runs, messages only contend with
+ * other messages injected by the same thread.
+ */
+struct LinkContentionModel : public LogPSwitch::ContentionModel
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    LogPSwitch::ContentionModel,
+    LinkContentionModel,
+    "macro",
+    "links",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "accounts for bandwidth used on each link along minimal routes")
+
+  LinkContentionModel(SST::Params& params) :
+    LogPSwitch::ContentionModel(params)
+  {
+    SST::Params topParams;
+    top_ = Topology::staticTopology(topParams);
+    radix_ = top_->maxNumPorts();
+
+    int nswitches = top_->numSwitches();
+    busy_until_.resize(uint64_t(nswitches) * radix_);
+    first_link_.resize(nswitches + 1);
+    std::vector<Topology::Connection> conns;
+    std::vector<Topology::InjectionPort> ports;
+    ejection_ports_.resize(top_->numNodes(), -1);
+    for (int sid=0; sid < nswitches; ++sid){
+      first_link_[sid] = links_.size();
+      top_->connectedOutports(sid, conns);
+      for (auto& conn : conns){
+        links_.emplace_back(conn.dst, conn.src_outport);
+      }
+      top_->endpointsConnectedToEjectionSwitch(sid, ports);
+      for (auto& port : ports){
+        ejection_ports_[port.nid] = port.switch_port;
+      }
+    }
+    first_link_[nswitches] = links_.size();
+  }
+
+  Timestamp extraDelay(GlobalTimestamp start, NetworkMessage* msg,
+                       Timestamp byte_delay, Timestamp hop_latency) override;
+
+ private:
+  typedef std::pair<SwitchId,int> Link;
+
+  /**
+   * @return The outport on sid on a minimal path to dst_sid for the flow,
+   *         with next set to the switch it leads to
+   */
+  int minimalPort(SwitchId sid, SwitchId dst_sid, uint64_t flow, SwitchId& next);
+
+  /**
+   * All packets of a flow hash to the same port so flows stay in order.
+   * The switch id is mixed in so that consecutive hops do not all make
+   * the same choice for a given flow.
+   */
+  static uint32_t flowHash(uint64_t flow, SwitchId sid) {
+    uint64_t h = flow ^ (uint64_t(sid) << 32);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return uint32_t(h);
+  }
+
+  Topology* top_;
+  int radix_;
+  std::vector<GlobalTimestamp> busy_until_;
+  //links_[first_link_[sid],first_link_[sid+1]) are the (dst,outport) links of sid
+  std::vector<uint64_t> first_link_;
+  std::vector<Link> links_;
+  std::vector<int> ejection_ports_;
+  //minimal links keyed by sid*num_switches + dst_sid, only for pairs that carry traffic
+  std::unordered_map<uint64_t,std::vector<Link>> minimal_links_;
+};
+
+int
+LinkContentionModel::minimalPort(SwitchId sid, SwitchId dst_sid, uint64_t flow, SwitchId& next)
+{
+  uint64_t key = uint64_t(sid) * top_->numSwitches() + dst_sid;
+  std::vector<Link>& minimal = minimal_links_[key];
+  if (minimal.empty()){
+    int dist = top_->switchDistance(sid, dst_sid);
+    for (uint64_t i=first_link_[sid]; i < first_link_[sid+1]; ++i){
+      const Link& link = links_[i];
+      if (top_->switchDistance(link.first, dst_sid) == dist - 1){
+        minimal.push_back(link);
+      }
+    }
+    if (minimal.empty()){
+      spkt_abort_printf("links contention model: no minimal path from switch %d to switch %d",
+                        int(sid), int(dst_sid));
+    }
+  }
+  const Link& link = minimal.size() == 1 ? minimal[0]
+                   : minimal[flowHash(flow, sid) % minimal.size()];
+  next = link.first;
+  return link.second;
+}
+
+Timestamp
+LinkContentionModel::extraDelay(GlobalTimestamp start, NetworkMessage* msg,
+                                Timestamp byte_delay, Timestamp hop_latency)
+{
+  SwitchId sid = top_->endpointToSwitch(msg->fromaddr());
+  SwitchId dst_sid = top_->endpointToSwitch(msg->toaddr());
+  Timestamp xfer_time = msg->byteLength() * byte_delay;
+  GlobalTimestamp head = start;
+  Timestamp wait;
+  while (true){
+    SwitchId next = sid;
+    //the last port is the ejection port to the node
+    int port = sid == dst_sid ? ejection_ports_[msg->toaddr()]
+                              : minimalPort(sid, dst_sid, msg->flowId(), next);
+    GlobalTimestamp& busy_until = busy_until_[uint64_t(sid)*radix_ + port];
+    if (busy_until > head){
+      wait += busy_until - head;
+      head = busy_until;
+    }
+    busy_until = head + xfer_time;
+    if (sid == dst_sid){
+      break;
+    }
+    sid = next;
+    head += hop_latency;
+  }
+
+  debug_printf(sprockit::dbg::logp,
+               "links contention delayed message %d->%d of size %d by %12.8e",
+               int(msg->fromaddr()), int(msg->toaddr()), int(msg->byteLength()),
+               wait.sec());
+  return wait;
+}
 
 }
 }
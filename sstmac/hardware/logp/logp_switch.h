@@ -84,7 +84,26 @@ class LogPSwitch : public ConnectableComponent
     SST_ELI_DECLARE_DEFAULT_INFO()
     SST_ELI_DECLARE_CTOR(SST::Params&)
 
-    virtual double value() = 0;
+    /**
+     * @return A multiplier on the bandwidth term of a message
+     */
+    virtual double value() {
+      return 0;
+    }
+
+    /**
+     * @brief extraDelay
+     * @param start       The time the message enters the network
+     * @param msg
+     * @param byte_delay  The uncontended delay per byte
+     * @param hop_latency The uncontended latency per switch hop
+     * @return The delay beyond the uncontended LogGP time. By default, this
+     *         scales the bandwidth term by value().
+     */
+    virtual Timestamp extraDelay(GlobalTimestamp start, NetworkMessage* msg,
+                                 Timestamp byte_delay, Timestamp hop_latency);
+
+    virtual ~ContentionModel(){}
 
     ContentionModel(SST::Params& params){}
   };
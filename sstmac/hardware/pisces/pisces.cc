@@ -66,7 +66,10 @@ PiscesPacket::PiscesPacket(
   bool is_tail,
   NodeId fromaddr,
   NodeId toaddr) :
-  Packet(msg, num_bytes, flow_id, is_tail, fromaddr, toaddr)
+  Packet(msg, num_bytes, flow_id, is_tail, fromaddr, toaddr),
+  current_vc_(0),
+  credit_starved_(false),
+  next_queued_(nullptr)
 {
 }
 
@@ -75,8 +78,8 @@ PiscesPacket::serialize_order(serializer& ser)
 {
   //routable::serialize_order(ser);
   Packet::serialize_order(ser);
-  ser & arrival_;
   ser & current_vc_;
+  ser & credit_starved_;
 }
 
 std::string
@@ -104,6 +107,7 @@ PiscesCredit::serialize_order(serializer& ser)
   ser & num_credits_;
   ser & port_;
   ser & vc_;
+  ser & batched_;
 }
 
 }
@@ -66,7 +66,7 @@ namespace hw {
  */
 class PiscesPacket :
   public Packet,
-  public sprockit::thread_safe_new<PiscesPacket>
+  public sprockit::thread_safe_new<PiscesPacket,PACKET_SLOT_ALIGNMENT>
 {
  public:
   ImplementSerializable(PiscesPacket)
@@ -141,14 +141,6 @@ class PiscesPacket :
     inport_ = port;
   }
 
-  GlobalTimestamp arrival() const {
-    return arrival_;
-  }
-
-  void setArrival(GlobalTimestamp time) {
-    arrival_ = time;
-  }
-
   void initByteDelay(Timestamp delay){
     if (byte_delay_.ticks() == 0){
       byte_delay_ = delay;
@@ -168,24 +160,50 @@ class PiscesPacket :
     byte_delay_ = std::max(delay, byte_delay_);
   }
 
+  /**
+   * @brief creditStarved Whether the stage that sent this packet was left
+   * without credits for another packet of the same size. A stage that
+   * batches credits returns them right away for such packets.
+   */
+  bool creditStarved() const {
+    return credit_starved_;
+  }
+
+  void setCreditStarved(bool flag){
+    credit_starved_ = flag;
+  }
+
+  /**
+   * @brief nextQueued Link for the intrusive PayloadQueue a packet waits in.
+   * A packet is only ever queued in one place at a time.
+   */
+  PiscesPacket* nextQueued() const {
+    return next_queued_;
+  }
+
+  void setNextQueued(PiscesPacket* next){
+    next_queued_ = next;
+  }
+
   void serialize_order(serializer& ser) override;
 
  private:
-  PiscesPacket(){} //for serialization
+  PiscesPacket() : next_queued_(nullptr) {} //for serialization
 
-  Timestamp byte_delay_;
-
-  GlobalTimestamp arrival_;
+  /** The small fields come first to fill the tail padding of Packet */
+  uint16_t inport_;
 
-  int current_vc_;
+  uint8_t current_vc_;
 
   uint8_t stage_;
 
   uint8_t outports_[3];
 
-  uint16_t inport_;
+  bool credit_starved_;
 
+  PiscesPacket* next_queued_;
 
+  Timestamp byte_delay_;
 
 };
 
@@ -204,10 +222,12 @@ class PiscesCredit :
   PiscesCredit(
     int port,
     int vc,
-    int num_credits)
+    int num_credits,
+    bool batched = false)
     : port_(port),
       num_credits_(num_credits),
-      vc_(vc)
+      vc_(vc),
+      batched_(batched)
   {
   }
 
@@ -223,6 +243,14 @@ class PiscesCredit :
     return num_credits_;
   }
 
+  /**
+   * @brief batched Whether this credit aggregates the credits of
+   * several packets and can therefore release several queued packets
+   */
+  bool batched() const {
+    return batched_;
+  }
+
   std::string toString() const override;
 
   void serialize_order(serializer& ser) override;
@@ -231,7 +259,7 @@ class PiscesCredit :
   int num_credits_;
   int port_;
   int vc_;
-
+  bool batched_;
 
 };
 
@@ -45,6 +45,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/pisces/pisces_arbitrator.h>
 
 #include <math.h>
+#include <algorithm>
 
 #define one_indent "  "
 #define two_indent "    "
@@ -168,14 +169,15 @@ PiscesNullArbitrator::arbitrate(IncomingPacket &st)
 
 PiscesCutThroughArbitrator::
 PiscesCutThroughArbitrator(double bw)
-  : head_(nullptr),
-    PiscesBandwidthArbitrator(bw)
+  : PiscesBandwidthArbitrator(bw),
+    head_(0)
 {
   cycleLength_ = byteDelay_;
   if (cycleLength_.sec() > 0.1) abort();
   if (cycleLength_.ticks() == 0) abort();
-  head_ = Epoch::allocateAtBeginning();
-  head_->numCycles = std::numeric_limits<uint32_t>::max();
+  Epoch first;
+  first.numCycles = std::numeric_limits<uint32_t>::max();
+  epochs_.push_back(first);
 }
 
 
@@ -189,17 +191,28 @@ PiscesCutThroughArbitrator::~PiscesCutThroughArbitrator()
 {
 }
 
+void
+PiscesCutThroughArbitrator::compact()
+{
+  //only pay for the shift once most of the storage is dead
+  if (head_ > 16 && 2*head_ > epochs_.size()){
+    epochs_.erase(epochs_.begin(), epochs_.begin() + head_);
+    head_ = 0;
+  }
+}
+
 void
 PiscesCutThroughArbitrator::clearOut(GlobalTimestamp now)
 {
-  Epoch* epoch = head_;
-  while (epoch){
+  while (true){
+    Epoch* epoch = &epochs_[head_];
+    bool isLast = (head_ + 1) == epochs_.size();
     cut_through_epoch_debug("clearing at %9.5e", now.sec());
     GlobalTimestamp end = epoch->start + epoch->numCycles * cycleLength_;
     if (now <= epoch->start){
-      return;
+      break;
     } else if (now < end){
-      if (epoch->next){
+      if (!isLast){
         Timestamp lostTime = now - epoch->start;
         uint32_t lostCycles = lostTime / cycleLength_;
         epoch->numCycles -= lostCycles;
@@ -208,31 +221,83 @@ PiscesCutThroughArbitrator::clearOut(GlobalTimestamp now)
         epoch->numCycles = std::numeric_limits<uint32_t>::max();
       }
       epoch->start = now;
-      return;
+      break;
+    } else if (!isLast){
+      ++head_;
     } else {
-      if (epoch->next){
-        Epoch* next = epoch->next;
-        delete epoch;
-        head_ = next;
-        epoch = next;
-      } else {
-        //this is the last epoch - restore it to "full size"
-        epoch->numCycles = std::numeric_limits<uint32_t>::max();
-        epoch->start = now;
-        return;
-      }
+      //this is the last epoch - restore it to "full size"
+      epoch->numCycles = std::numeric_limits<uint32_t>::max();
+      epoch->start = now;
+      break;
     }
   }
+  compact();
+}
+
+size_t
+PiscesCutThroughArbitrator::advance(size_t idx)
+{
+  if (idx == head_){
+    //dropping the front epoch is just an index bump
+    return ++head_;
+  } else {
+    //the live epochs before idx shift up over it, which only touches
+    //the epochs this packet already walked past
+    std::move_backward(epochs_.begin() + head_, epochs_.begin() + idx,
+                       epochs_.begin() + idx + 1);
+    ++head_;
+    return idx + 1;
+  }
+}
+
+size_t
+PiscesCutThroughArbitrator::split(size_t idx, const Epoch& next)
+{
+  if (head_ == 0){
+    epochs_.insert(epochs_.begin() + idx + 1, next);
+    return idx;
+  } else {
+    //reuse a dead slot at the front rather than shifting the tail
+    std::move(epochs_.begin() + head_, epochs_.begin() + idx + 1,
+              epochs_.begin() + head_ - 1);
+    --head_;
+    epochs_[idx] = next;
+    return idx - 1;
+  }
 }
 
-PiscesCutThroughArbitrator::Epoch*
-PiscesCutThroughArbitrator::advance(Epoch* epoch, Epoch* prev)
+bool
+PiscesCutThroughArbitrator::arbitrateIdle(IncomingPacket &st)
 {
-  Epoch* next = epoch->next;
-  if (prev) prev->next = epoch->next;
-  else head_ = next;
-  delete epoch;
-  return next;
+  //idle means only the trailing, unbounded epoch is left and it has begun
+  if (head_ + 1 != epochs_.size() || st.now < epochs_[head_].start){
+    return false;
+  }
+
+  uint32_t numBytes = st.pkt->numBytes();
+  //slowly arriving packets split epochs and stragglers are special cased,
+  //leave both to the full model
+  if (numBytes <= 2 || st.pkt->byteDelay() > cycleLength_){
+    return false;
+  }
+
+  Epoch& epoch = epochs_[head_];
+  if (st.now > epoch.start){
+    //same as clearOut - restore the last epoch to "full size"
+    epoch.numCycles = std::numeric_limits<uint32_t>::max();
+    epoch.start = st.now;
+  }
+  //every cycle gets used from now until the tail leaves
+  st.head_leaves = epoch.start;
+  epoch.start += numBytes * cycleLength_;
+  epoch.numCycles -= numBytes;
+  st.tail_leaves = epoch.start;
+  st.pkt->setByteDelay((st.tail_leaves - st.head_leaves) / numBytes);
+
+  pflow_arb_debug_printf_l0("Cut-through: arbitrator %p idle fast path for packet %p:%llu of size %u head=%9.5e tail=%9.5e",
+                          this, st.pkt, st.pkt->flowId(), numBytes,
+                          st.head_leaves.sec(), st.tail_leaves.sec());
+  return true;
 }
 
 void
@@ -246,10 +311,8 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
 #define PRINT_EPOCHS 0
 #if PRINT_EPOCHS
   std::cout << "------" << std::endl;
-  Epoch* start_ep = head_;
-  while(start_ep){
-    std::cout << "Start epoch " << this << ": " << start_ep->start.time.ticks() << ": " << start_ep->numCycles << std::endl;
-    start_ep = start_ep->next;
+  for (size_t i=head_; i < epochs_.size(); ++i){
+    std::cout << "Start epoch " << this << ": " << epochs_[i].start.time.ticks() << ": " << epochs_[i].numCycles << std::endl;
   }
   std::cout << "------" << std::endl;
 #endif
@@ -257,18 +320,18 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
   clearOut(st.now);
 
   GlobalTimestamp fullyBufferedTime = st.now + st.pkt->byteDelay() * st.pkt->numBytes();
-  Epoch* epoch = head_;
-  Epoch* prev = nullptr;
+  size_t idx = head_;
   uint32_t bytesSent = 0;
   uint32_t bytesLeft = st.pkt->numBytes();
   //first idle epoch
-  st.head_leaves = epoch->start;
+  st.head_leaves = epochs_[idx].start;
   while (bytesLeft > 2){ //we often end up with 1,2 byte stragglers - ignore them for efficiency
 #if SSTMAC_SANITY_CHECK
-    if (!epoch){
+    if (idx >= epochs_.size()){
       spkt_abort_printf("ran out of epochs on arbitrator %p: this should not be possible", this);
     }
 #endif
+    Epoch* epoch = &epochs_[idx];
     Timestamp epochLength = epoch->numCycles * cycleLength_;
     GlobalTimestamp epochEnd = epoch->start + epochLength;
     if (st.pkt->byteDelay() <= cycleLength_){
@@ -278,7 +341,7 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
         //epoch is completely busy
         bytesSent += epoch->numCycles;
         bytesLeft -= epoch->numCycles;
-        epoch = advance(epoch, prev);
+        idx = advance(idx);
         st.tail_leaves = epochEnd;
       } else {
         //epoch has to split into busy and idle halves
@@ -298,12 +361,11 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
           cut_through_arb_debug_noargs("buffering finishes after epoch: epoch used up");
           bytesSent += epoch->numCycles;
           bytesLeft -= epoch->numCycles;
-          epoch = advance(epoch, prev);
+          idx = advance(idx);
         } else {
           cut_through_arb_debug_noargs("buffering finishes after epoch: epoch has leftover cycles");
           epoch->numCycles -= bytesBuffered;
-          prev = epoch;
-          epoch = epoch->next;
+          ++idx;
           bytesSent += bytesBuffered;
           bytesLeft -= bytesBuffered;
         }
@@ -323,30 +385,28 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
           bytesLeft -= epoch->numCycles;
           bytesSent += epoch->numCycles;
           //epoch is used up
-          epoch = advance(epoch, prev);
+          idx = advance(idx);
           st.tail_leaves = epochEnd;
         }
       } else {
         //buffering finishes in the middle of the epoch
         //split the epochs on buffering finishing and repeat
-        Epoch* next = new Epoch;
+        Epoch next;
         Timestamp deltaT = fullyBufferedTime - epoch->start;
         uint32_t preCycles = deltaT  / cycleLength_;
         uint32_t postCycles = epoch->numCycles - preCycles;
         cut_through_arb_debug("buffering finishes during epoch: pre=%u post=%u",
                               preCycles, postCycles);
         epoch->numCycles = preCycles;
-        if (epoch->next){
+        if (idx + 1 < epochs_.size()){
           //there are more epochs after this
-          next->next = epoch->next;
-          next->numCycles = postCycles;
+          next.numCycles = postCycles;
         } else {
-          next->next = nullptr;
           //oh, this is the last epoch - replenish the cycles
-          next->numCycles = std::numeric_limits<uint32_t>::max();
+          next.numCycles = std::numeric_limits<uint32_t>::max();
         }
-        next->start = epoch->start + deltaT;
-        epoch->next = next;
+        next.start = epoch->start + deltaT;
+        idx = split(idx, next);
       }
     }
   }
@@ -355,22 +415,19 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
   st.pkt->setByteDelay(newByteDelay);
 
 #if SSTMAC_SANITY_CHECK
-  Epoch* end_ep = head_;
   GlobalTimestamp end_last;
-  while(end_ep){
+  for (size_t i=head_; i < epochs_.size(); ++i){
+    const Epoch& end_ep = epochs_[i];
 #if PRINT_EPOCHS
-    std::cout << "End epoch " << this << ": " << end_ep->start.time.ticks() << ": " << end_ep->numCycles << std::endl;
+    std::cout << "End epoch " << this << ": " << end_ep.start.time.ticks() << ": " << end_ep.numCycles << std::endl;
 #endif
-    if (end_last > end_ep->start){
-      Epoch* test = head_;
-      while (test){
-        std::cerr << "Epoch " << test->start.time.ticks() << ": " << test->numCycles << std::endl;
-        test = test->next;
+    if (end_last > end_ep.start){
+      for (size_t j=head_; j < epochs_.size(); ++j){
+        std::cerr << "Epoch " << epochs_[j].start.time.ticks() << ": " << epochs_[j].numCycles << std::endl;
       }
       spkt_abort_printf("arbitration epochs go backward in time");
     }
-    end_last = end_ep->start;
-    end_ep = end_ep->next;
+    end_last = end_ep.start;
   }
 #endif
 
@@ -51,6 +51,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/factory.h>
 #include <sstmac/hardware/noise/noise.h>
 
+#include <vector>
+
 namespace sstmac {
 namespace hw {
 
@@ -84,6 +86,16 @@ class PiscesBandwidthArbitrator
   */
   virtual void arbitrate(IncomingPacket& st) = 0;
 
+  /**
+      Closed-form arbitration for a link with nothing in flight. Gives
+      exactly the result of arbitrate() when it succeeds.
+      @return Whether the link was idle. If false, st is untouched and the
+              full arbitrate() must be used.
+  */
+  virtual bool arbitrateIdle(IncomingPacket& st){
+    return false;
+  }
+
   virtual Timestamp headTailDelay(PiscesPacket* pkt) = 0;
 
   virtual std::string toString() const = 0;
@@ -193,6 +205,8 @@ class PiscesCutThroughArbitrator :
 
   void arbitrate(IncomingPacket& st) override;
 
+  bool arbitrateIdle(IncomingPacket& st) override;
+
   std::string toString() const override {
     return "cut through arbitrator";
   }
@@ -200,17 +214,38 @@ class PiscesCutThroughArbitrator :
   Timestamp headTailDelay(PiscesPacket *pkt) override;
 
  private:
-  struct Epoch : public sprockit::thread_safe_new<Epoch> {
+  /**
+   * An idle interval of the link. The live epochs are stored contiguously
+   * in time order in epochs_[head_,end). Epochs that expire are dropped
+   * from the front by advancing head_ and the vector is only compacted
+   * once most of it is dead, so pruning is amortized constant time
+   * and arbitration never allocates in steady state. Epochs used up or
+   * split behind the head move the few live epochs before them into
+   * the dead front slots instead of shifting the whole tail.
+   */
+  struct Epoch {
     GlobalTimestamp start;
     uint32_t numCycles;
-    Epoch* next;
   };
 
-  Epoch* advance(Epoch* epoch, Epoch* prev);
+  /**
+   * Drop the used up epoch at idx
+   * @return The index of the epoch that followed it
+   */
+  size_t advance(size_t idx);
+
+  /**
+   * Insert next right after the epoch at idx
+   * @return The new index of the epoch at idx
+   */
+  size_t split(size_t idx, const Epoch& next);
 
   void clearOut(GlobalTimestamp now);
 
-  Epoch* head_;
+  void compact();
+
+  std::vector<Epoch> epochs_;
+  size_t head_;
   Timestamp cycleLength_;
   GlobalTimestamp lastEpochEnd_;
 
@@ -72,6 +72,9 @@ PiscesBranchedSwitch::PiscesBranchedSwitch(uint32_t id, SST::Params& params)
   n_local_ports_ = args[0];
   n_local_xbars_ = args[1];
 
+  SST::Params link_params = params.find_scoped_params("link");
+  PiscesSender::rejectCreditBatching(link_params, "the pisces branched switch");
+
   initComponents(params);
 }
 
@@ -79,6 +79,7 @@ PiscesBuffer::setOutput(int this_outport, int dst_inport, EventLink::ptr&& link,
     credits_[i] = num_credits_per_vc;
     initial_credits_[i] = num_credits_per_vc;
   }
+  busy_bytes_ = 0;
 }
 
 PiscesBuffer::PiscesBuffer(const std::string& selfname,
@@ -90,6 +91,7 @@ PiscesBuffer::PiscesBuffer(const std::string& selfname,
     queues_(num_vc),
     credits_(num_vc, 0),
     initial_credits_(num_vc,0),
+    busy_bytes_(0),
     packet_size_(packet_size),
     xmit_wait_(nullptr)
 {
@@ -122,6 +124,7 @@ PiscesBuffer::handleCredit(Event* ev)
 #endif
   int& num_credits = credits_[vc];
   num_credits += credit->numCredits();
+  busy_bytes_ -= credit->numCredits();
   //we've cleared out some of the delay
   bytes_delayed_ -= credit->numCredits();
 
@@ -141,6 +144,10 @@ PiscesBuffer::handleCredit(Event* ev)
     spkt_abort_printf("initial credits exceeded on %s",
                       toString().c_str());
   }
+
+  if (busy_bytes_ < 0){
+    spkt_abort_printf("negative busy bytes on %s", toString().c_str());
+  }
 #endif
 
   /** while we have sendable payloads, do it */
@@ -149,10 +156,12 @@ PiscesBuffer::handleCredit(Event* ev)
   while (payload) {
     collectIdleTicks();
     num_credits -= payload->numBytes();
+    busy_bytes_ += payload->numBytes();
     //this actually doesn't create any new delay
     //this message was already queued so num_bytes
     //was already added to bytes_delayed
-    last_tail_left_ = send(arb_, payload, input_, output_);
+    last_tail_left_ = send(arb_, payload, input_, output_,
+                           num_credits < int(payload->numBytes()));
     payload = queues_[vc].pop(num_credits);
   }
 
@@ -163,7 +172,6 @@ void
 PiscesBuffer::handlePayload(Event* ev)
 {
   auto pkt = static_cast<PiscesPacket*>(ev);
-  pkt->setArrival(now());
   int dst_vc = pkt->vc();
 
 #if SSTMAC_SANITY_CHECK
@@ -184,7 +192,9 @@ PiscesBuffer::handlePayload(Event* ev)
   bytes_delayed_ += pkt->numBytes();
   if (num_credits >= pkt->numBytes()) {
     num_credits -= pkt->numBytes();
-    last_tail_left_ = send(arb_, pkt, input_, output_);
+    busy_bytes_ += pkt->numBytes();
+    last_tail_left_ = send(arb_, pkt, input_, output_,
+                           num_credits < int(pkt->numBytes()));
   } else {
 #if SSTMAC_SANITY_CHECK
     if (dst_vc >= queues_.size()){
@@ -198,14 +208,15 @@ PiscesBuffer::handlePayload(Event* ev)
 GlobalTimestamp
 PiscesBuffer::sendPayload(PiscesPacket *pkt)
 {
-  pkt->setArrival(now());
   int dst_vc = pkt->vc();
   int& num_credits = credits_[dst_vc];
   // it either gets queued or gets sent
   // either way there's a delay accumulating for other messages
   bytes_delayed_ += pkt->numBytes();
   num_credits -= pkt->numBytes();
-  last_tail_left_ = send(arb_, pkt, input_, output_);
+  busy_bytes_ += pkt->numBytes();
+  last_tail_left_ = send(arb_, pkt, input_, output_,
+                         num_credits < int(pkt->numBytes()));
   return last_tail_left_;
 }
 
@@ -215,12 +226,8 @@ PiscesBuffer::queueLength(int vc) const
   if (vc >= 0){
     int busyBytes = initial_credits_[vc] - credits_[vc];
     return busyBytes / packet_size_;
-  } else { //ah, okay, check all VCs
-    int busyBytes = 0;
-    for (int i=0; i < credits_.size(); ++i){
-      busyBytes += initial_credits_[i] - credits_[i];
-    }
-    return busyBytes / packet_size_;
+  } else { //ah, okay, all VCs
+    return busy_bytes_ / packet_size_;
   }
 }
 
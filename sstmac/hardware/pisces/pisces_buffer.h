@@ -64,6 +64,14 @@ class PiscesBuffer :
 
   void setInput(int this_inport, int src_outport, EventLink::ptr&& link) override;
 
+  /**
+   * @brief setDirectInput Return credits on a zero-latency input
+   * straight to the previous stage when they are ready immediately
+   */
+  void setDirectInput(PiscesSender* prev){
+    input_.direct = prev;
+  }
+
   void handleCredit(Event* ev) override;
 
   void handlePayload(Event* ev) override;
@@ -99,10 +107,11 @@ class PiscesBuffer :
   std::vector<PayloadQueue> queues_;
   std::vector<int> credits_;
   std::vector<int> initial_credits_;
+  //bytes outstanding downstream summed over all VCs,
+  //kept in step with credits_ so all-VC queue lengths are O(1)
+  int busy_bytes_;
 
   PiscesBandwidthArbitrator* arb_;
-  std::set<int> deadlocked_channels_;
-  std::map<int, std::list<PiscesPacket*> > blocked_messages_;
   int packet_size_;
   GlobalTimestamp last_tail_left_;
   Statistic<double>* xmit_wait_;
@@ -153,7 +153,11 @@ PiscesNtoMQueue::sendPayload(PiscesPacket* pkt)
     spkt_abort_printf("got bad inport %d on stage %d", port, int(pkt->stage()));
   }
 #endif
-  send(arb_, pkt, inputs_[pkt->nextLocalInport()], outputs_[pkt->nextLocalOutport()]);
+  //credits for the packet were already taken from its output slot
+  int dst_vc = update_vc_ ? pkt->nextVC() : pkt->vc();
+  bool starved = credit(pkt->nextLocalOutport(), dst_vc) < int(pkt->numBytes());
+  send(arb_, pkt, inputs_[pkt->nextLocalInport()], outputs_[pkt->nextLocalOutport()],
+       starved);
 }
 
 void
@@ -184,20 +188,33 @@ PiscesNtoMQueue::handleCredit(Event *ev)
   }
 #endif
 
-  PiscesPacket* payload = queue(pkt->port(), pkt->vc()).pop(num_credits);
-  if (payload) {
+  //a batched credit can free several packets, otherwise release
+  //one packet per credit as each credit stands for one packet
+  PayloadQueue& q = queue(pkt->port(), pkt->vc());
+  PiscesPacket* payload = q.pop(num_credits);
+  while (payload) {
     num_credits -= payload->numBytes();
     sendPayload(payload);
+    if (!pkt->batched()) break;
+    payload = q.pop(num_credits);
   }
   delete pkt;
 }
 
+bool
+PiscesNtoMQueue::takeCredit(int port, int vc, int num_bytes)
+{
+  if (!queue(port, vc).empty()){
+    return false;
+  }
+  credit(port, vc) += num_bytes;
+  return true;
+}
+
 void
 PiscesNtoMQueue::handlePayload(Event* ev)
 {
   auto pkt = static_cast<PiscesPacket*>(ev);
-  pkt->setArrival(now());
-
   int dst_vc = update_vc_ ? pkt->nextVC() : pkt->vc();
   int loc_port = pkt->nextLocalOutport();
   pisces_debug(
@@ -70,6 +70,8 @@ class PiscesNtoMQueue :
 
   void handleCredit(Event* ev) override;
 
+  bool takeCredit(int port, int vc, int num_bytes) override;
+
   LinkHandler* creditHandler();
 
   LinkHandler* payloadHandler();
@@ -78,6 +80,14 @@ class PiscesNtoMQueue :
 
   void setOutput(int my_outport, int dst_inport, EventLink::ptr&& link, int credits) override;
 
+  /**
+   * @brief setDirectOutput Deliver packets on a zero-latency output
+   * straight to the next stage whenever they depart immediately
+   */
+  void setDirectOutput(int my_outport, PiscesSender* next){
+    outputs_[my_outport].direct = next;
+  }
+
   inline int slot(int port, int vc) const {
     return port * num_vc_ + vc;
   }
@@ -97,10 +107,6 @@ class PiscesNtoMQueue :
 
   int num_vc_;
 
-  std::map<int, std::set<int> > deadlocked_channels_;
-
-  std::map<int, std::map<int, std::list<PiscesPacket*> > > blocked_messages_;
-
  protected:
   void sendPayload(PiscesPacket* pkt);
 
@@ -181,7 +181,6 @@ PiscesMemoryModel::access(int channel, PiscesPacket* pkt, Timestamp byte_delay,
 
   //set the bandwidth to the max single bw
   pkt->initByteDelay(byte_delay);
-  pkt->setArrival(now());
   PiscesBandwidthArbitrator::IncomingPacket st;
   st.pkt = pkt;
   st.now = now();
@@ -68,6 +68,8 @@ PiscesNIC::PiscesNIC(SST::Params& params, Node* parent) :
 {
   SST::Params inj_params = params.find_scoped_params("injection");
   SST::Params ej_params = params.find_scoped_params("ejection");
+  PiscesSender::rejectCreditBatching(inj_params, "the pisces NIC");
+  PiscesSender::rejectCreditBatching(ej_params, "the pisces NIC");
 
   self_mtl_link_ = allocateSubLink("mtl", Timestamp(), parent,
                                     newLinkHandler(this, &NIC::mtlHandle));
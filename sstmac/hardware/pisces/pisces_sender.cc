@@ -46,6 +46,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/router/router.h>
 #include <sstmac/hardware/network/network_message.h>
 #include <sstmac/hardware/topology/topology.h>
+#include <sstmac/common/event_callback.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/output.h>
 #include <sprockit/util.h>
@@ -61,13 +62,20 @@ namespace hw {
 PiscesPacket*
 PayloadQueue::pop(int num_credits)
 {
-  auto it = queue.begin(), end = queue.end();
-  for (; it != end; ++it){
-    PiscesPacket* pkt = *it;
+  PiscesPacket* prev = nullptr;
+  PiscesPacket* pkt = head;
+  while (pkt){
     if (pkt->numBytes() <= num_credits){
-      queue.erase(it);
+      PiscesPacket* next = pkt->nextQueued();
+      if (prev) prev->setNextQueued(next);
+      else head = next;
+      if (pkt == tail) tail = prev;
+      pkt->setNextQueued(nullptr);
+      --count;
       return pkt;
     }
+    prev = pkt;
+    pkt = pkt->nextQueued();
   }
   return nullptr;
 }
@@ -77,39 +85,155 @@ PiscesSender::PiscesSender(
   SST::Component* parent,
   bool update_vc) :
   SubComponent(selfname, parent), //no self handlers
-  update_vc_(update_vc)
+  update_vc_(update_vc),
+  credit_batch_bytes_(0),
+  credit_flush_scheduled_(false)
 {
 }
 
+void
+PiscesSender::setCreditBatching(int batch_bytes, Timestamp max_delay)
+{
+  credit_batch_bytes_ = batch_bytes;
+  credit_batch_delay_ = max_delay;
+}
+
 void
 PiscesSender::sendCredit(
   Input& inp, PiscesPacket* payload,
   GlobalTimestamp credits_ready)
 {
   int src_vc = payload->vc(); //we have not updated to the new virtual channel
-  PiscesCredit* credit = new PiscesCredit(inp.port_to_credit,
-                                         src_vc, payload->numBytes());
-
-  Timestamp credit_departure_delay = credits_ready - now();
 
   pisces_debug(
       "On %s:%p on inport %d, crediting %s:%p port:%d:%d vc:%d {%s}"
-      "after delay %9.5e after latency %9.5e with %p",
+      "after delay %9.5e after latency %9.5e",
       toString().c_str(), this, int(payload->nextLocalInport()),
       inp.link->toString().c_str(), inp.link.get(),
       payload->edgeOutport(), payload->nextLocalOutport(), src_vc,
       payload->toString().c_str(),
-      credit_departure_delay.sec(), credit_lat_.sec(),
-      credit);
+      (credits_ready - now()).sec(), credit_lat_.sec());
+
+  if (credit_batch_bytes_ > 0){
+    //the previous stage is stalled waiting on credits - don't hold them back
+    batchCredit(inp, src_vc, payload->numBytes(), credits_ready,
+                payload->creditStarved());
+  } else {
+    sendCredit(inp, src_vc, payload->numBytes(), credits_ready, false);
+  }
+}
+
+void
+PiscesSender::rejectCreditBatching(SST::Params& params, const char* name)
+{
+  if (params.contains("credit_batch_size")){
+    spkt_abort_printf("credit_batch_size is not supported by %s - "
+                      "only the pisces switch batches credits", name);
+  }
+}
+
+void
+PiscesSender::sendCredit(Input& inp, int vc, int num_bytes,
+                         GlobalTimestamp credits_ready, bool batched)
+{
   //simulate more realistic pipelining of credits
+  GlobalTimestamp now_ = now();
+  if (inp.direct && credits_ready <= now_
+      && inp.direct->takeCredit(inp.port_to_credit, vc, num_bytes)){
+    return;
+  }
+  PiscesCredit* credit = new PiscesCredit(inp.port_to_credit, vc, num_bytes, batched);
+  Timestamp credit_departure_delay = credits_ready > now_
+      ? credits_ready - now_ : Timestamp();
   inp.link->send(credit_departure_delay, credit);
 }
 
+void
+PiscesSender::batchCredit(Input& inp, int vc, int num_bytes,
+                          GlobalTimestamp credits_ready, bool flush)
+{
+  if (vc >= int(inp.pending.size())){
+    inp.pending.resize(vc+1);
+  }
+  PendingCredit& pending = inp.pending[vc];
+
+  if (pending.bytes > 0 && credits_ready > pending.deadline){
+    //never hold the older credits past their deadline
+    sendCredit(inp, vc, pending.bytes, pending.deadline, true);
+    pending.bytes = 0;
+  }
+
+  if (pending.bytes == 0){
+    pending.deadline = credits_ready + credit_batch_delay_;
+  }
+  pending.bytes += num_bytes;
+  pending.ready = credits_ready;
+
+  if (flush || pending.bytes >= credit_batch_bytes_){
+    sendCredit(inp, vc, pending.bytes, pending.ready, true);
+    pending.bytes = 0;
+    return;
+  }
+
+  if (!pending.scheduled){
+    pending.scheduled = true;
+    pending_credits_.emplace_back(&inp, vc);
+  }
+
+  if (!credit_flush_scheduled_ || pending.deadline < next_credit_flush_){
+    scheduleCreditFlush(pending.deadline);
+  }
+}
+
+void
+PiscesSender::scheduleCreditFlush(GlobalTimestamp t)
+{
+  credit_flush_scheduled_ = true;
+  next_credit_flush_ = t;
+  sendExecutionEvent(t, newCallback(this, &PiscesSender::flushCredits));
+}
+
+void
+PiscesSender::flushCredits()
+{
+  GlobalTimestamp now_ = now();
+  if (now_ >= next_credit_flush_){
+    //this is the earliest outstanding flush - any others are stale
+    credit_flush_scheduled_ = false;
+  }
+  GlobalTimestamp next_deadline;
+  int num_left = 0;
+  for (auto& pair : pending_credits_){
+    Input* inp = pair.first;
+    int vc = pair.second;
+    PendingCredit& pending = inp->pending[vc];
+    if (pending.bytes == 0){
+      //already went out on a full batch
+      pending.scheduled = false;
+    } else if (pending.deadline <= now_){
+      sendCredit(*inp, vc, pending.bytes, pending.ready, true);
+      pending.bytes = 0;
+      pending.scheduled = false;
+    } else {
+      if (num_left == 0 || pending.deadline < next_deadline){
+        next_deadline = pending.deadline;
+      }
+      pending_credits_[num_left++] = pair;
+    }
+  }
+  pending_credits_.resize(num_left);
+
+  if (num_left > 0 && (!credit_flush_scheduled_ || next_deadline < next_credit_flush_)){
+    scheduleCreditFlush(next_deadline);
+  }
+}
+
 GlobalTimestamp
 PiscesSender::send(
   PiscesBandwidthArbitrator* arb,
   PiscesPacket* pkt,
-  Input& to_credit, Output& to_send)
+  Input& to_credit, Output& to_send,
+  bool credit_starved)
 {
   GlobalTimestamp now_ = now();
   PiscesBandwidthArbitrator::IncomingPacket st;
@@ -120,7 +244,8 @@ PiscesSender::send(
   st.dst_inport = pkt->nextLocalInport();
 
   if (arb) {
-    arb->arbitrate(st);
+    //an uncontended link has a closed-form answer
+    if (!arb->arbitrateIdle(st)) arb->arbitrate(st);
   } else {
     st.head_leaves = st.tail_leaves = now_;
   }
@@ -149,9 +274,16 @@ PiscesSender::send(
   //weird hack to update vc from routing
   if (update_vc_) pkt->updateVC();
   pkt->advanceStage();
+  //the incoming flag was consumed by the credit above, now describe this stage
+  pkt->setCreditStarved(credit_starved);
 
   Timestamp departure_delay = st.head_leaves - now_;
-  to_send.link->send(departure_delay, pkt);
+  if (to_send.direct && departure_delay.ticks() == 0){
+    //nothing ahead of the packet, skip the event for the zero-latency hop
+    to_send.direct->handlePayload(pkt);
+  } else {
+    to_send.link->send(departure_delay, pkt);
+  }
 
   return st.tail_leaves;
 }
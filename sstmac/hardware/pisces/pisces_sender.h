@@ -57,28 +57,42 @@ Questions? Contact sst-macro-help@sandia.gov
 namespace sstmac {
 namespace hw {
 
+/**
+ * FIFO of packets waiting on credits. The queue is threaded through the
+ * packets themselves so that queueing never allocates and an empty queue
+ * is just two null pointers.
+ */
 struct PayloadQueue {
 
-  std::list<PiscesPacket*> queue;
+  PiscesPacket* head;
+  PiscesPacket* tail;
+  uint32_t count;
 
-  typedef std::list<PiscesPacket*>::iterator iterator;
+  PayloadQueue() : head(nullptr), tail(nullptr), count(0) {}
 
   PiscesPacket* pop(int num_credits);
 
   PiscesPacket* front(){
-    if (queue.empty()){
-      return nullptr;
-    }
-    return queue.front();
+    return head;
   }
 
+  bool empty() const {
+    return head == nullptr;
+  }
 
   size_t size() const {
-    return queue.size();
+    return count;
   }
 
   void push_back(PiscesPacket* payload){
-    queue.push_back(payload);
+    payload->setNextQueued(nullptr);
+    if (tail){
+      tail->setNextQueued(payload);
+    } else {
+      head = payload;
+    }
+    tail = payload;
+    ++count;
   }
 
 };
@@ -86,16 +100,35 @@ struct PayloadQueue {
 class PiscesSender : public SubComponent
 {
  public:
+  /**
+   * Credits held back on an input for a given VC when credit batching
+   * is enabled. They go out as a single PiscesCredit once enough bytes
+   * have accumulated or the oldest held credit reaches its deadline.
+   */
+  struct PendingCredit {
+    int bytes;
+    bool scheduled;
+    GlobalTimestamp ready;
+    GlobalTimestamp deadline;
+    PendingCredit() : bytes(0), scheduled(false) {}
+  };
+
   struct Input {
     int port_to_credit;
     EventLink::ptr link;
-    Input() : link(nullptr){}
+    //the stage behind a zero-latency link, credited without an event when possible
+    PiscesSender* direct;
+    //indexed by vc, only used with credit batching
+    std::vector<PendingCredit> pending;
+    Input() : link(nullptr), direct(nullptr){}
   };
 
   struct Output {
     int arrival_port;
     EventLink::ptr link;
-    Output() : link(nullptr){}
+    //the stage behind a zero-latency link, handed packets without an event when possible
+    PiscesSender* direct;
+    Output() : link(nullptr), direct(nullptr){}
   };
 
   virtual ~PiscesSender() {}
@@ -108,16 +141,56 @@ class PiscesSender : public SubComponent
 
   virtual void handleCredit(Event* ev) = 0;
 
+  /**
+   * @brief takeCredit Return credits in place of a zero-delay credit event
+   * @return Whether the credits were taken. False if returning them would
+   *         release queued packets, which must go through handleCredit.
+   */
+  virtual bool takeCredit(int port, int vc, int num_bytes){
+    return false;
+  }
+
   virtual std::string piscesName() const = 0;
 
   std::string toString() const override;
 
+  /**
+   * @brief setCreditBatching Return credits to the previous stage lazily.
+   * Credits for the same input and VC are aggregated into one credit event.
+   * @param batch_bytes Send the aggregated credit once this many bytes are held.
+   *                    Zero (the default) disables batching.
+   * @param max_delay   Upper bound on how long any single credit is held back
+   */
+  void setCreditBatching(int batch_bytes, Timestamp max_delay);
+
+  /**
+   * @brief rejectCreditBatching Abort if credit batching is requested
+   * for a component that cannot batch its credits
+   * @param params The parameter namespace credit_batch_size would be read from
+   * @param name   The component type, for the error message
+   */
+  static void rejectCreditBatching(SST::Params& params, const char* name);
+
  protected:
   PiscesSender(const std::string& selfname, SST::Component* parent, bool update_vc);
 
   void sendCredit(Input& inp, PiscesPacket* payload,
           GlobalTimestamp packet_tail_leaves);
 
+  void sendCredit(Input& inp, int vc, int num_bytes,
+                  GlobalTimestamp credits_ready, bool batched);
+
+  /**
+   * @param flush Send the batch right away, e.g. because the previous
+   *              stage has run out of credits and is waiting on these
+   */
+  void batchCredit(Input& inp, int vc, int num_bytes,
+                   GlobalTimestamp credits_ready, bool flush);
+
+  void flushCredits();
+
+  void scheduleCreditFlush(GlobalTimestamp t);
+
   /**
    * @brief send Invoked to send/bandwidth arbitrator a packet.
    * Only called when there are enough credits to hold packet on other side.
@@ -125,10 +198,13 @@ class PiscesSender : public SubComponent
    * @param pkt
    * @param to_credit
    * @param to_send
+   * @param credit_starved Whether this stage is left without credits
+   *        for another packet like pkt on the output
    * @return
    */
   GlobalTimestamp send(PiscesBandwidthArbitrator* arb,
-       PiscesPacket* pkt, Input& to_credit, Output& to_send);
+       PiscesPacket* pkt, Input& to_credit, Output& to_send,
+       bool credit_starved);
 
  protected:
   Timestamp send_lat_;
@@ -137,6 +213,16 @@ class PiscesSender : public SubComponent
 
   bool update_vc_;
 
+  int credit_batch_bytes_;
+
+  Timestamp credit_batch_delay_;
+
+  bool credit_flush_scheduled_;
+
+  GlobalTimestamp next_credit_flush_;
+
+  std::vector<std::pair<Input*,int>> pending_credits_;
+
 };
 
 }
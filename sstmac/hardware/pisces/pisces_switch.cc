@@ -59,6 +59,9 @@ RegisterKeywords(
 { "latency", "latency to traverse a portion of the switch - sets both credit/send" },
 { "credits", "the number of initial credits available to switch component" },
 { "num_vc", "the number of virtual channels a switch must allow" },
+{ "credit_batch_size", "aggregate returned credits until this many bytes are pending" },
+{ "credit_batch_delay", "the maximum time a credit can be held back for batching" },
+{ "queue_length_staleness", "how often adaptive routers see updated queue lengths" },
 );
 
 
@@ -93,11 +96,9 @@ PiscesAbstractSwitch::~PiscesAbstractSwitch()
   if (router_) delete router_;
 }
 
-PiscesSwitch::PiscesSwitch(uint32_t id, SST::Params& params)
-: PiscesAbstractSwitch(id, params),
-  xbar_(nullptr)
+void
+PiscesAbstractSwitch::initLinkParams(SST::Params& params)
 {
-  SST::Params xbar_params = params.find_scoped_params("xbar");
   SST::Params link_params = params.find_scoped_params("link");
 
   if (params.contains("arbitrator")){
@@ -106,10 +107,6 @@ PiscesSwitch::PiscesSwitch(uint32_t id, SST::Params& params)
     arbType_ = link_params.find<std::string>("arbitrator");
   }
 
-  double xbar_bw = xbar_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
-
-  std::string xbar_arb = xbar_params.find<std::string>("arbitrator", arbType_);
-
   link_bw_ = link_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
   if (link_params.contains("credits")){
     link_credits_ = link_params.find<SST::UnitAlgebra>("credits").getRoundedValue();
@@ -119,15 +116,46 @@ PiscesSwitch::PiscesSwitch(uint32_t id, SST::Params& params)
     link_credits_ = 8*link_bw_*lat_s;
   }
 
+  mtu_ = params.find<SST::UnitAlgebra>("mtu").getRoundedValue();
+  if (link_credits_ < mtu_){
+    spkt_abort_printf("MTU %d is larger than credits %d", mtu_, link_credits_);
+  }
+}
+
+PiscesSwitch::PiscesSwitch(uint32_t id, SST::Params& params)
+: PiscesAbstractSwitch(id, params),
+  xbar_(nullptr)
+{
+  SST::Params xbar_params = params.find_scoped_params("xbar");
+  SST::Params link_params = params.find_scoped_params("link");
+
+  initLinkParams(params);
+
+  double xbar_bw = xbar_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
+
+  std::string xbar_arb = xbar_params.find<std::string>("arbitrator", arbType_);
+
   if (xbar_params.contains("credits")){
     xbar_credits_ = xbar_params.find<SST::UnitAlgebra>("credits").getRoundedValue();
   } else {
     xbar_credits_ = link_credits_;
   }
 
+  credit_batch_size_ = 0;
+  if (link_params.contains("credit_batch_size")){
+    credit_batch_size_ = link_params.find<SST::UnitAlgebra>("credit_batch_size").getRoundedValue();
+    if (link_params.contains("credit_batch_delay")){
+      credit_batch_delay_ = Timestamp(link_params.find<SST::UnitAlgebra>("credit_batch_delay").getValue().toDouble());
+    } else {
+      //by default, never hold a credit longer than it takes to cross the link
+      credit_batch_delay_ = Timestamp(link_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
+    }
+  }
+
   xbar_ = new PiscesCrossbar("xbar", xbar_arb, xbar_bw, this,
                              top_->maxNumPorts(), top_->maxNumPorts(),
                              router_->numVC(), true/*yes, update vc*/);
+  xbar_->setCreditBatching(credit_batch_size_, credit_batch_delay_);
   out_buffers_.resize(top_->maxNumPorts());
   inports_.resize(top_->maxNumPorts());
   for (int i=0; i < inports_.size(); ++i){
@@ -136,10 +164,9 @@ PiscesSwitch::PiscesSwitch(uint32_t id, SST::Params& params)
     inp.parent = this;
   }
 
-  mtu_ = params.find<SST::UnitAlgebra>("mtu").getRoundedValue();
-
-  if (link_credits_ < mtu_){
-    spkt_abort_printf("MTU %d is larger than credits %d", mtu_, link_credits_);
+  if (params.contains("queue_length_staleness")){
+    queue_staleness_ = Timestamp(params.find<SST::UnitAlgebra>("queue_length_staleness").getValue().toDouble());
+    queue_estimates_.resize(top_->maxNumPorts());
   }
 
   initLinks(params);
@@ -166,6 +193,7 @@ PiscesSwitch::connectOutput(
   PiscesBuffer* out_buffer = new PiscesBuffer(sprockit::printf("%s:buffer%d",top_->switchIdToName(my_addr_).c_str(), src_outport),
                                               arbType_, link_bw_ * scale_factor, mtu_,
                                               this, router_->numVC());
+  out_buffer->setCreditBatching(credit_batch_size_, credit_batch_delay_);
   int buffer_inport = 0;
   std::string out_port_name = sprockit::printf("buffer-out%d", src_outport);
   auto out_link = allocateSubLink(out_port_name, Timestamp(), this, //don't put latency on xbar
@@ -176,6 +204,10 @@ PiscesSwitch::connectOutput(
   auto in_link = allocateSubLink(in_port_name, Timestamp(), this, xbar_->creditHandler()); //don't put latency on internal credits
   out_buffer->setInput(buffer_inport, src_outport, std::move(in_link));
   out_buffers_[src_outport] = out_buffer;
+  //the xbar and buffer sit behind zero-latency links,
+  //so uncontended packets and credits skip the events between them
+  xbar_->setDirectOutput(src_outport, out_buffer);
+  out_buffer->setDirectInput(xbar_);
 
   out_buffer->setOutput(src_outport, dst_inport, std::move(link), link_credits_ * scale_factor);
   out_buffers_[src_outport] = out_buffer;
@@ -202,7 +234,19 @@ int
 PiscesSwitch::queueLength(int port, int vc) const
 {
   PiscesBuffer* buf = static_cast<PiscesBuffer*>(out_buffers_[port]);
-  return buf->queueLength(vc);
+  if (queue_staleness_.ticks() == 0 || vc >= 0){
+    return buf->queueLength(vc);
+  }
+
+  //model hardware that only samples congestion periodically
+  QueueEstimate& est = queue_estimates_[port];
+  GlobalTimestamp now_ = now();
+  if (!est.valid || (now_ - est.sampled) >= queue_staleness_){
+    est.length = buf->queueLength(vc);
+    est.sampled = now_;
+    est.valid = true;
+  }
+  return est.length;
 }
 
 std::string
@@ -66,8 +66,17 @@ class PiscesAbstractSwitch :
 
   virtual ~PiscesAbstractSwitch();
 
+  /**
+   * Read the arbitrator, link bandwidth, link credits and MTU
+   * shared by all switch models that end in pisces output buffers
+   */
+  void initLinkParams(SST::Params& params);
+
   std::string arbType_;
   Router* router_;
+  double link_bw_;
+  int link_credits_;
+  int mtu_;
 };
 
 /**
@@ -135,12 +144,22 @@ class PiscesSwitch :
   std::vector<PiscesSender*> out_buffers_;
   std::vector<InputPort> inports_;
 
+  struct QueueEstimate {
+    int length;
+    bool valid;
+    GlobalTimestamp sampled;
+    QueueEstimate() : length(0), valid(false) {}
+  };
+
+  //only used if adaptive routers should see stale queue lengths
+  mutable std::vector<QueueEstimate> queue_estimates_;
+  Timestamp queue_staleness_;
+
   PiscesCrossbar* xbar_;
 
   int xbar_credits_;
-  double link_bw_;
-  int link_credits_;
-  int mtu_;
+  int credit_batch_size_;
+  Timestamp credit_batch_delay_;
 };
 
 }
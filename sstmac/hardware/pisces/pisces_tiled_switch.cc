@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/topology/structured_topology.h>
 #include <sstmac/hardware/nic/nic.h>
 #include <sstmac/common/event_manager.h>
+#include <sstmac/common/event_callback.h>
 #include <sprockit/util.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
@@ -59,18 +60,32 @@ RegisterKeywords(
 { "row_buffer_size", "the size of the input buffer in each row" },
 { "nrows", "the number of row tiles in a switch" },
 { "ncols", "the number of col tiles in a switch" },
+{ "tile_model", "whether tiles are separate components (events) or computed in one step (analytic)" },
 );
 
 namespace sstmac {
 namespace hw {
 
 PiscesTiledSwitch::PiscesTiledSwitch(uint32_t id, SST::Params& params)
-  : PiscesAbstractSwitch(id, params)
+  : PiscesAbstractSwitch(id, params),
+    analytic_(false)
 {
   nrows_ = params.find<int>("nrows");
   ncols_ = params.find<int>("ncols");
 
-  initComponents(params);
+  SST::Params link_params = params.find_scoped_params("link");
+  PiscesSender::rejectCreditBatching(link_params, "the pisces tiled switch");
+
+  std::string tile_model = params.find<std::string>("tile_model", "events");
+  if (tile_model == "analytic"){
+    analytic_ = true;
+    initAnalytic(params);
+  } else if (tile_model == "events"){
+    initComponents(params);
+  } else {
+    spkt_abort_printf("invalid tile_model %s for tiled switch: must be events or analytic",
+                      tile_model.c_str());
+  }
 }
 
 PiscesTiledSwitch::~PiscesTiledSwitch()
@@ -84,6 +99,9 @@ PiscesTiledSwitch::~PiscesTiledSwitch()
   for (PiscesMuxer* mux : col_output_muxers_){
     if (mux) delete mux;
   }
+  for (PiscesBuffer* buf : out_buffers_){
+    if (buf) delete buf;
+  }
 }
 
 int
@@ -183,9 +201,147 @@ PiscesTiledSwitch::initComponents(SST::Params& params)
 #endif
 }
 
+void
+PiscesTiledSwitch::initAnalytic(SST::Params& params)
+{
+  int ntiles = nrows_ * ncols_;
+  int nports = top_->maxNumPorts();
+  if (nports > ntiles){
+    spkt_abort_printf("tiled switch %d has %d ports, but only %dx%d tiles",
+                      int(my_addr_), nports, nrows_, ncols_);
+  }
+
+  initLinkParams(params);
+
+  SST::Params xbar_params = params.find_scoped_params("xbar");
+  double xbar_bw = xbar_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
+  tile_byte_delay_ = Timestamp(1.0/xbar_bw);
+
+  row_free_.resize(ntiles * ncols_);
+  col_free_.resize(ntiles * nrows_);
+  out_credits_.resize(nports * router_->numVC());
+  out_queues_.resize(nports * router_->numVC());
+  out_buffers_.resize(nports);
+  inports_.resize(nports);
+  for (int i=0; i < nports; ++i){
+    inports_[i].parent = this;
+    inports_[i].port = i;
+    inports_[i].src_outport = 0;
+  }
+
+  initLinks(params);
+}
+
+void
+PiscesTiledSwitch::InputPort::handle(Event* ev)
+{
+  parent->traverseTiles(static_cast<PiscesPacket*>(ev), port);
+}
+
+void
+PiscesTiledSwitch::traverseTiles(PiscesPacket* pkt, int inport)
+{
+  router_->route(pkt);
+  int outport = pkt->edgeOutport();
+  pkt->resetStages(outport, 0);
+  pkt->setInport(inport);
+
+  int in_row, in_col, out_row, out_col;
+  tileToRowCol(inport, in_row, in_col);
+  tileToRowCol(outport, out_row, out_col);
+
+  //the row bus carries the packet to the tile in the output column,
+  //the tile then drives it down the column to the output row
+  GlobalTimestamp& row_free = row_free_[inport*ncols_ + out_col];
+  GlobalTimestamp& col_free = col_free_[rowColToTile(in_row, out_col)*nrows_ + out_row];
+
+  Timestamp byte_delay = std::max(pkt->byteDelay(), tile_byte_delay_);
+  Timestamp xfer_time = pkt->numBytes() * byte_delay;
+  GlobalTimestamp now_ = now();
+  GlobalTimestamp head = row_free > now_ ? row_free : now_;
+  row_free = head + xfer_time;
+  if (col_free > head) head = col_free;
+  col_free = head + xfer_time;
+  pkt->setByteDelay(byte_delay);
+
+  debug_printf(sprockit::dbg::pisces,
+               "tiled switch %d: payload %s from port %d (%d,%d) to port %d (%d,%d) reaches output at %9.5e",
+               int(my_addr_), pkt->toString().c_str(), inport, in_row, in_col,
+               outport, out_row, out_col, head.sec());
+
+  if (head > now_){
+    sendExecutionEvent(head, newCallback(this, &PiscesTiledSwitch::deliver, pkt));
+  } else {
+    deliver(pkt);
+  }
+}
+
+void
+PiscesTiledSwitch::deliver(PiscesPacket* pkt)
+{
+  int slot = outSlot(pkt->nextLocalOutport(), pkt->nextVC());
+  int& num_credits = out_credits_[slot];
+  if (num_credits >= int(pkt->numBytes())){
+    num_credits -= pkt->numBytes();
+    sendToBuffer(pkt);
+  } else {
+    out_queues_[slot].push_back(pkt);
+  }
+}
+
+void
+PiscesTiledSwitch::sendToBuffer(PiscesPacket* pkt)
+{
+  //the input buffer is freed once the packet is in the output buffer
+  InputPort& inp = inports_[pkt->nextLocalInport()];
+  if (inp.link){
+    //credits go back on the vc the packet arrived on
+    inp.link->send(Timestamp(), new PiscesCredit(inp.src_outport, pkt->vc(), pkt->numBytes()));
+  }
+  int outport = pkt->nextLocalOutport();
+  pkt->updateVC();
+  pkt->advanceStage();
+  out_buffers_[outport]->handlePayload(pkt);
+}
+
+void
+PiscesTiledSwitch::handleTileCredit(Event* ev)
+{
+  PiscesCredit* credit = static_cast<PiscesCredit*>(ev);
+  int slot = outSlot(credit->port(), credit->vc());
+  int& num_credits = out_credits_[slot];
+  num_credits += credit->numCredits();
+  PayloadQueue& q = out_queues_[slot];
+  PiscesPacket* pkt = q.pop(num_credits);
+  while (pkt){
+    num_credits -= pkt->numBytes();
+    sendToBuffer(pkt);
+    pkt = q.pop(num_credits);
+  }
+  delete credit;
+}
+
 void
 PiscesTiledSwitch::connectOutput(int src_outport, int dst_inport, EventLink::ptr&& link)
 {
+  if (analytic_){
+    double scale_factor = top_->portScaleFactor(my_addr_, src_outport);
+    int credits = link_credits_ * scale_factor;
+    PiscesBuffer* out_buffer = new PiscesBuffer(
+          sprockit::printf("%s:buffer%d", top_->switchIdToName(my_addr_).c_str(), src_outport),
+          arbType_, link_bw_ * scale_factor, mtu_, this, router_->numVC());
+    std::string in_port_name = sprockit::printf("tile-credit%d", src_outport);
+    auto in_link = allocateSubLink(in_port_name, Timestamp(), this,
+                     newLinkHandler(this, &PiscesTiledSwitch::handleTileCredit));
+    out_buffer->setInput(0, src_outport, std::move(in_link));
+    out_buffer->setOutput(src_outport, dst_inport, std::move(link), credits);
+    for (int vc=0; vc < router_->numVC(); ++vc){
+      out_credits_[outSlot(src_outport, vc)] = credits / router_->numVC();
+    }
+    out_buffers_[src_outport] = out_buffer;
+    return;
+  }
+
   //TODO
 #if 0
   PiscesSender* muxer = col_output_muxers_[src_outport];
@@ -197,6 +353,13 @@ PiscesTiledSwitch::connectOutput(int src_outport, int dst_inport, EventLink::ptr
 void
 PiscesTiledSwitch::connectInput(int src_outport, int dst_inport, EventLink::ptr&& link)
 {
+  if (analytic_){
+    InputPort& inp = inports_[dst_inport];
+    inp.src_outport = src_outport;
+    inp.link = std::move(link);
+    return;
+  }
+
   //TODO
 #if 0
   int row = dst_inport % nrows_;
@@ -208,6 +371,9 @@ PiscesTiledSwitch::connectInput(int src_outport, int dst_inport, EventLink::ptr&
 int
 PiscesTiledSwitch::queueLength(int port, int vc) const
 {
+  if (analytic_){
+    return out_buffers_[port]->queueLength(vc);
+  }
   spkt_throw_printf(sprockit::UnimplementedError,
     "PiscesTiledSwitch::queue_length");
 }
@@ -253,15 +419,44 @@ PiscesTiledSwitch::toString() const
   return sprockit::printf("pisces tiled switch %d", int(my_addr_));
 }
 
+void
+PiscesTiledSwitch::setup()
+{
+  for (auto* buf : out_buffers_){
+    if (buf) buf->setup();
+  }
+  PiscesAbstractSwitch::setup();
+}
+
+void
+PiscesTiledSwitch::init(unsigned int phase)
+{
+  for (auto* buf : out_buffers_){
+    if (buf) buf->init(phase);
+  }
+  PiscesAbstractSwitch::init(phase);
+}
+
 LinkHandler*
 PiscesTiledSwitch::creditHandler(int port)
 {
+  if (analytic_){
+    int nbuffers = out_buffers_.size();
+    if (port >= nbuffers){
+      spkt_abort_printf("Got invalid port %d request for credit handler - max is %d",
+                        port, nbuffers - 1);
+    }
+    return newLinkHandler(out_buffers_[port], &PiscesSender::handleCredit);
+  }
   return newLinkHandler(this, &PiscesTiledSwitch::handleCredit);
 }
 
 LinkHandler*
 PiscesTiledSwitch::payloadHandler(int port)
 {
+  if (analytic_){
+    return newLinkHandler(&inports_[port], &InputPort::handle);
+  }
   return newLinkHandler(this, &PiscesTiledSwitch::handlePayload);
 }
 
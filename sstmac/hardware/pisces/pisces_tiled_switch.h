@@ -66,7 +66,7 @@ class PiscesTiledSwitch :
     NetworkSwitch,
     PiscesTiledSwitch,
     "macro",
-    "pisces_tiled",
+    "pisces_tiled_switch",
     SST_ELI_ELEMENT_VERSION(1,0,0),
     "A tiled network switch implementing the packet flow congestion model",
     COMPONENT_CATEGORY_NETWORK)
@@ -87,6 +87,10 @@ class PiscesTiledSwitch :
 
   LinkHandler* payloadHandler(int port) override;
 
+  void setup() override;
+
+  void init(unsigned int phase) override;
+
   void handleCredit(Event* ev);
 
   void handlePayload(Event* ev);
@@ -100,7 +104,7 @@ class PiscesTiledSwitch :
   }
 
   int getCol(int tile) const {
-    return tile / nrows_;
+    return tile % ncols_;
   }
 
  protected:
@@ -115,13 +119,68 @@ class PiscesTiledSwitch :
 
   int row_buffer_num_bytes_;
 
+  /**
+   * With tile_model=analytic the tiles are not separate components.
+   * A packet's trip from its input row through a crossbar tile to the
+   * output column is computed directly on arrival from per-resource
+   * busy-until times, giving one internal event per traversal instead
+   * of a payload and credit event per tile. The output links still use
+   * full PiscesBuffers so that credits to the next switch are unchanged.
+   */
+  bool analytic_;
+
+  //busy-until time of the row bus from each input port to each column
+  std::vector<GlobalTimestamp> row_free_;
+
+  //busy-until time of each crossbar tile output to each row in its column
+  std::vector<GlobalTimestamp> col_free_;
+
+  Timestamp tile_byte_delay_;
+
+  //bytes free in each output buffer, indexed by port*num_vc + vc
+  std::vector<int> out_credits_;
+
+  //packets through the tiles waiting for output buffer space
+  std::vector<PayloadQueue> out_queues_;
+
+  std::vector<PiscesBuffer*> out_buffers_;
+
+  struct InputPort {
+    PiscesTiledSwitch* parent;
+    int port;
+    //the port on the sender that credits go back to
+    int src_outport;
+    EventLink::ptr link;
+
+    void handle(Event* ev);
+
+    std::string toString() const {
+      return parent->toString();
+    }
+  };
+  std::vector<InputPort> inports_;
+
  private:
+  void traverseTiles(PiscesPacket* pkt, int inport);
+
+  void deliver(PiscesPacket* pkt);
+
+  void sendToBuffer(PiscesPacket* pkt);
+
+  void handleTileCredit(Event* ev);
+
+  int outSlot(int port, int vc) const {
+    return port * router_->numVC() + vc;
+  }
+
   int rowColToTile(int row, int col);
 
   void tileToRowCol(int tile, int& row, int& col);
 
   void initComponents(SST::Params& params);
 
+  void initAnalytic(SST::Params& params);
+
 
 };
 
@@ -104,6 +104,8 @@ InstructionProcessor::compute(Event* ev, ExecutionEvent* cb)
   int nthread = st.nthread;
   // compute execution time in seconds
   Timestamp instr_time = instructionTime(bev) / nthread;
+  if (st.imbalance != 1.0) instr_time *= st.imbalance;
+  instr_time += st.overhead;
   // now count the number of bytes
   uint64_t bytes = st.mem_sequential;
   // max_single_mem_bw is the bandwidth achievable if ZERO instructions are executed
@@ -58,11 +58,21 @@ Questions? Contact sst-macro-help@sandia.gov
 
 RegisterKeywords(
 { "fileroot", "the file prefix for reading in tables" },
+{ "filename", "the JSON file to read routing tables from" },
+{ "num_vc", "the number of virtual channels the routing tables use" },
+{ "multipath", "how to pick among several ports for a destination: hash or adaptive" },
 );
 
 namespace sstmac {
 namespace hw {
 
+/**
+ * Routes are read from a JSON file of the form
+ *  "switches" : { "switch0" : { "routes" : { "nid0" : <route>, ... } } }
+ * where a route is either a single port, a list of equivalent ports,
+ * or an object { "ports" : [...], "vc" : <vc> }.
+ * Port lists are stored as one CSR array so the table stays compact.
+ */
 class TableRouter : public Router {
  public:
   SST_ELI_REGISTER_DERIVED(
@@ -75,30 +85,72 @@ class TableRouter : public Router {
 
   TableRouter(SST::Params& params, Topology* top, NetworkSwitch* sw) :
     Router(params, top, sw),
-    table_(top->numNodes(), -1)
+    offsets_(top->numNodes() + 1, 0),
+    vcs_(top->numNodes(), 0),
+    adaptive_(false)
   {
     std::string fname = params.find<std::string>("filename");
     std::ifstream in(fname);
     nlohmann::json jsn;
     in >> jsn;
 
+    num_vc_ = params.find<int>("num_vc", 1);
+
+    std::string multipath = params.find<std::string>("multipath", "hash");
+    if (multipath == "adaptive"){
+      adaptive_ = true;
+    } else if (multipath != "hash"){
+      spkt_abort_printf("invalid table router multipath %s: must be hash or adaptive",
+                        multipath.c_str());
+    }
+
     nlohmann::json routes =
         jsn.at("switches").at( top->switchIdToName(my_addr_) ).at("routes");
-    int size = table_.size();
-    for (auto it = routes.begin(); it != routes.end(); ++it)
-      table_[top->nodeNameToId(it.key())] = it.value();
 
-    for (int i=0; i < table_.size(); ++i){
-      if (table_[i] == -1){
+    //two passes - count the ports for each destination, then fill them in
+    std::vector<const nlohmann::json*> entries(vcs_.size(), nullptr);
+    for (auto it = routes.begin(); it != routes.end(); ++it){
+      int dst = top->nodeNameToId(it.key());
+      const nlohmann::json& val = it.value();
+      const nlohmann::json* ports = &val;
+      if (val.is_object()){
+        ports = &val.at("ports");
+        vcs_[dst] = val.value("vc", 0);
+        if (vcs_[dst] >= num_vc_){
+          spkt_abort_printf("switch %d route to %d uses vc %d, but table router has num_vc=%d",
+                            my_addr_, dst, int(vcs_[dst]), num_vc_);
+        }
+      }
+      entries[dst] = ports;
+      offsets_[dst+1] = ports->is_array() ? ports->size() : 1;
+    }
+
+    for (size_t i=0; i < entries.size(); ++i){
+      if (offsets_[i+1] == 0){
         spkt_abort_printf("No port specified on switch %d to destination %d",
-                          my_addr_, i);
+                          my_addr_, int(i));
+      }
+      offsets_[i+1] += offsets_[i];
+    }
+
+    ports_.resize(offsets_.back());
+    for (size_t i=0; i < entries.size(); ++i){
+      const nlohmann::json& ports = *entries[i];
+      int offset = offsets_[i];
+      if (ports.is_array()){
+        for (auto& p : ports) ports_[offset++] = p;
+      } else {
+        ports_[offset] = ports;
       }
     }
 
+    if (adaptive_ && !netsw_){
+      spkt_abort_printf("adaptive table routing needs a switch to query queue lengths");
+    }
   }
 
   int numVC() const override {
-    return 1;
+    return num_vc_;
   }
 
   std::string toString() const override {
@@ -106,15 +158,58 @@ class TableRouter : public Router {
   }
 
   void route(Packet *pkt) override {
-    int port = table_[pkt->toaddr()];
+    int dst = pkt->toaddr();
+    int first = offsets_[dst];
+    int num_ports = offsets_[dst+1] - first;
+    int port;
+    if (num_ports == 1){
+      port = ports_[first];
+    } else if (adaptive_){
+      port = leastLoaded(&ports_[first], num_ports);
+    } else {
+      port = ports_[first + flowHash(pkt->flowId()) % num_ports];
+    }
     pkt->setEdgeOutport(port);
-    //for now only valid on topologies with minimal/no vcs
-    pkt->setDeadlockVC(0);
-    rter_debug("packet to %d sent to port %d", pkt->toaddr(), port);
+    //vcs come from the table, no deadlock avoidance is done here
+    pkt->setDeadlockVC(vcs_[dst]);
+    rter_debug("packet to %d sent to port %d of %d choices", dst, port, num_ports);
   }
 
  private:
-  std::vector<int> table_;
+  /**
+   * All packets of a flow hash to the same port so flows stay in order.
+   * The switch id is mixed in so that consecutive stages do not all make
+   * the same choice for a given flow.
+   */
+  uint32_t flowHash(uint64_t flow) const {
+    uint64_t h = flow ^ (uint64_t(my_addr_) << 32);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return uint32_t(h);
+  }
+
+  int leastLoaded(const uint16_t* ports, int num_ports) const {
+    int best = ports[0];
+    int best_length = netsw_->queueLength(best, -1);
+    for (int i=1; i < num_ports; ++i){
+      int length = netsw_->queueLength(ports[i], -1);
+      if (length < best_length){
+        best = ports[i];
+        best_length = length;
+      }
+    }
+    return best;
+  }
+
+  /** CSR index into ports_, one entry per destination node plus one */
+  std::vector<uint32_t> offsets_;
+  std::vector<uint16_t> ports_;
+  std::vector<uint8_t> vcs_;
+  int num_vc_;
+  bool adaptive_;
 };
 
 }
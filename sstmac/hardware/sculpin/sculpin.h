@@ -65,7 +65,7 @@ namespace hw {
  */
 class SculpinPacket :
   public Packet,
-  public sprockit::thread_safe_new<SculpinPacket>
+  public sprockit::thread_safe_new<SculpinPacket,PACKET_SLOT_ALIGNMENT>
 {
   ImplementSerializable(SculpinPacket)
 
@@ -123,6 +123,7 @@ class SculpinPacket :
   void serialize_order(serializer& ser) override;
 
  private:
+  /** Fills the tail padding of Packet */
   uint32_t seqnum_;
 
   GlobalTimestamp arrival_;
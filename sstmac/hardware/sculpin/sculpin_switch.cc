@@ -82,6 +82,52 @@ RegisterKeywords(
 namespace sstmac {
 namespace hw {
 
+void
+SculpinSwitch::PacketQueue::push(SculpinPacket* pkt)
+{
+  Entry e;
+  e.arrival = pkt->arrival();
+  e.priority = pkt->priority();
+  e.seqnum = pkt->seqnum();
+  e.pkt = pkt;
+
+  size_t idx = heap_.size();
+  heap_.push_back(e);
+  while (idx > 0){
+    size_t parent = (idx - 1) / arity;
+    if (!before(e, heap_[parent])) break;
+    heap_[idx] = heap_[parent];
+    idx = parent;
+  }
+  heap_[idx] = e;
+}
+
+SculpinPacket*
+SculpinSwitch::PacketQueue::pop()
+{
+  SculpinPacket* top = heap_.front().pkt;
+  Entry last = heap_.back();
+  heap_.pop_back();
+  size_t n = heap_.size();
+  if (n == 0) return top;
+
+  size_t idx = 0;
+  while (true){
+    size_t first = idx * arity + 1;
+    if (first >= n) break;
+    size_t last_child = std::min(first + arity, n);
+    size_t best = first;
+    for (size_t c=first+1; c < last_child; ++c){
+      if (before(heap_[c], heap_[best])) best = c;
+    }
+    if (!before(heap_[best], last)) break;
+    heap_[idx] = heap_[best];
+    idx = best;
+  }
+  heap_[idx] = last;
+  return top;
+}
+
 SculpinSwitch::SculpinSwitch(uint32_t id, SST::Params& params) :
   router_(nullptr),
   congestion_(true),
@@ -242,9 +288,7 @@ SculpinSwitch::pullNext(int portnum)
                       int(addr()), p.id);
   }
   pkt_debug("pulling pending packet from port %d with %d queued", portnum, p.priority_queue.size());
-  auto iter = p.priority_queue.begin();
-  SculpinPacket* pkt = *iter;
-  p.priority_queue.erase(iter);
+  SculpinPacket* pkt = p.priority_queue.pop();
   send(p, pkt, now());
 }
 
@@ -274,7 +318,7 @@ SculpinSwitch::tryToSendPacket(SculpinPacket* pkt)
       pkt_debug("new packet has to schedule pull from port %d at t=%8.4e", p.id, p.next_free.sec());
     }
     pkt_debug("new packet has to wait on queue on port %d with %d queued", p.id, p.priority_queue.size());
-    p.priority_queue.insert(pkt);
+    p.priority_queue.push(pkt);
   } else if (p.priority_queue.empty()){
     //nothing there - go ahead and send
     send(p, pkt, now_);
@@ -282,7 +326,7 @@ SculpinSwitch::tryToSendPacket(SculpinPacket* pkt)
     //race condition - there is something in the queue
     //I must hop in the queue as well
     pkt_debug("new packet has to wait on queue on port %d with %d queued", p.id, p.priority_queue.size());
-    p.priority_queue.insert(pkt);
+    p.priority_queue.push(pkt);
   }
 }
 
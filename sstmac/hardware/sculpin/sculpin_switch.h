@@ -112,19 +112,50 @@ class SculpinSwitch :
   std::string toString() const override;
 
  private:
-  struct priority_compare {
-    bool operator()(SculpinPacket* l, SculpinPacket* r) const {
-      if (l->priority() == r->priority()){
-        if (l->arrival() == r->arrival()){
-          return l->seqnum() < r->seqnum();
+  /**
+   * A 4-ary min-heap of queued packets ordered by (priority, arrival, seqnum).
+   * The ordering keys are copied into the heap entries so that sifting never
+   * dereferences the packets, and the backing vector keeps its capacity
+   * so that steady-state queueing does not allocate.
+   */
+  class PacketQueue {
+   public:
+    bool empty() const {
+      return heap_.empty();
+    }
+
+    size_t size() const {
+      return heap_.size();
+    }
+
+    void push(SculpinPacket* pkt);
+
+    SculpinPacket* pop();
+
+   private:
+    struct Entry {
+      GlobalTimestamp arrival;
+      int priority;
+      uint32_t seqnum;
+      SculpinPacket* pkt;
+    };
+
+    static bool before(const Entry& l, const Entry& r){
+      if (l.priority == r.priority){
+        if (l.arrival == r.arrival){
+          return l.seqnum < r.seqnum;
         } else {
-          return l->arrival() < r->arrival();
+          return l.arrival < r.arrival;
         }
       } else {
         //zero is highest priority
-        return l->priority() < r->priority();
+        return l.priority < r.priority;
       }
     }
+
+    static const int arity = 4;
+
+    std::vector<Entry> heap_;
   };
 
   struct Port {
@@ -133,7 +164,7 @@ class SculpinSwitch :
     GlobalTimestamp next_free;
     Timestamp byte_delay;
     uint32_t seqnum;
-    std::set<SculpinPacket*, priority_compare> priority_queue;
+    PacketQueue priority_queue;
     EventLink::ptr link;
     Port() : link(nullptr){}
   };
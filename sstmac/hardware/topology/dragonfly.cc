@@ -133,6 +133,46 @@ Dragonfly::minimalDistance(SwitchId src, SwitchId dst) const
   }
 }
 
+int
+Dragonfly::switchDistance(SwitchId src, SwitchId dst) const
+{
+  if (src == dst) return 0;
+
+  int srcA, srcG; getCoords(src, srcA, srcG);
+  int dstA, dstG; getCoords(dst, dstA, dstG);
+  //groups are all-to-all
+  if (srcG == dstG) return 1;
+
+  //best of local hop (maybe), group link, local hop (maybe)
+  int dist = -1;
+  std::vector<int> connected;
+  for (int a=0; a < a_; ++a){
+    group_wiring_->connectedRouters(a, srcG, connected);
+    for (int partner : connected){
+      if (computeG(partner) == dstG){
+        int d = (a != srcA) + 1 + (partner != int(dst));
+        if (dist < 0 || d < dist) dist = d;
+      }
+    }
+  }
+  if (dist < 0){
+    //no direct group link, paths go through other groups
+    return Topology::switchDistance(src, dst);
+  }
+  if (dist == 3){
+    //two group links through a third group can beat the local hops
+    std::vector<int> hop_connected;
+    group_wiring_->connectedRouters(srcA, srcG, connected);
+    for (int hop : connected){
+      group_wiring_->connectedRouters(computeA(hop), computeG(hop), hop_connected);
+      for (int partner : hop_connected){
+        if (partner == int(dst)) return 2;
+      }
+    }
+  }
+  return dist;
+}
+
 void
 Dragonfly::connectedOutports(SwitchId src, std::vector<Connection>& conns) const
 {
@@ -213,6 +213,8 @@ class Dragonfly : public CartesianTopology
 
   int minimalDistance(SwitchId src, SwitchId dst) const;
 
+  int switchDistance(SwitchId src, SwitchId dst) const override;
+
   int numHopsToNode(NodeId src, NodeId dst) const override {
     return minimalDistance(src / concentration_, dst / concentration_);
   }
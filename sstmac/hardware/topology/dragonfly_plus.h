@@ -134,6 +134,11 @@ class DragonflyPlus : public Dragonfly
 
   int minimalDistance(SwitchId src, SwitchId dst) const;
 
+  int switchDistance(SwitchId src, SwitchId dst) const override {
+    //groups are leaf/spine rather than all-to-all, use the searched table
+    return Topology::switchDistance(src, dst);
+  }
+
   int numHopsToNode(NodeId src, NodeId dst) const override {
     return minimalDistance(src / concentration_, dst/ concentration_);
   }
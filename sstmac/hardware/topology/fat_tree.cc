@@ -43,6 +43,7 @@ Questions? Contact sst-macro-help@sandia.gov
 */
 
 #include <sstream>
+#include <algorithm>
 #include <sstmac/hardware/topology/fat_tree.h>
 #include <sstmac/hardware/router/router.h>
 #include <sstmac/backends/common/sim_partition.h>
@@ -149,6 +150,94 @@ FatTree::FatTree(SST::Params& params) :
 
   // check for errors
   checkInput();
+  initCoreGroups();
+}
+
+void
+FatTree::initCoreGroups()
+{
+  if (up_ports_per_leaf_switch_ != agg_switches_per_subtree_
+      || down_ports_per_agg_switch_ != leaf_switches_per_subtree_){
+    return;
+  }
+
+  SwitchId first_core = num_leaf_switches_ + num_agg_switches_;
+  std::vector<int> core_group(num_core_switches_, -1);
+  std::vector<int> agg_group(num_agg_switches_);
+  std::vector<std::vector<SwitchId>> group_cores;
+  std::vector<Connection> conns;
+  std::vector<SwitchId> cores;
+  for (int a=0; a < num_agg_switches_; ++a){
+    connectedOutports(num_leaf_switches_ + a, conns);
+    cores.clear();
+    for (auto& conn : conns){
+      if (conn.dst >= first_core) cores.push_back(conn.dst);
+    }
+    std::sort(cores.begin(), cores.end());
+    cores.erase(std::unique(cores.begin(), cores.end()), cores.end());
+    if (cores.empty()) return;
+
+    int g = core_group[cores[0] - first_core];
+    if (g < 0){
+      g = group_cores.size();
+      for (SwitchId c : cores){
+        //cores shared by aggs that are not in the same group
+        if (core_group[c - first_core] >= 0) return;
+        core_group[c - first_core] = g;
+      }
+      group_cores.push_back(cores);
+    } else if (group_cores[g] != cores){
+      return;
+    }
+    agg_group[a] = g;
+  }
+
+  for (int g : core_group){
+    if (g < 0) return;
+  }
+  for (int s=0; s < num_agg_subtrees_; ++s){
+    std::vector<bool> covered(group_cores.size(), false);
+    for (int q=0; q < agg_switches_per_subtree_; ++q){
+      covered[agg_group[s*agg_switches_per_subtree_ + q]] = true;
+    }
+    for (bool c : covered){
+      if (!c) return;
+    }
+  }
+
+  core_group_ = std::move(core_group);
+  agg_group_ = std::move(agg_group);
+}
+
+int
+FatTree::switchDistance(SwitchId src, SwitchId dst) const
+{
+  if (core_group_.empty()){
+    return Topology::switchDistance(src, dst);
+  }
+  if (src == dst) return 0;
+
+  int src_lvl = level(src);
+  int dst_lvl = level(dst);
+  //links are bidirectional, so order by level
+  if (src_lvl > dst_lvl){
+    std::swap(src, dst);
+    std::swap(src_lvl, dst_lvl);
+  }
+  switch (src_lvl*3 + dst_lvl){
+  case 0: //leaf-leaf
+    return subtree(src) == subtree(dst) ? 2 : 4;
+  case 1: //leaf-agg
+    return subtree(src) == subtree(dst) ? 1 : 3;
+  case 2: //leaf-core, through an agg of the core's group
+    return 2;
+  case 4: //agg-agg, through a leaf or a core
+    return subtree(src) == subtree(dst) || group(src) == group(dst) ? 2 : 4;
+  case 5: //agg-core
+    return group(src) == group(dst) ? 1 : 3;
+  default: //core-core
+    return group(src) == group(dst) ? 2 : 4;
+  }
 }
 
 Topology::VTKSwitchGeometry
@@ -480,6 +569,31 @@ TaperedFatTree::TaperedFatTree(SST::Params& params) :
   agg_bw_multiplier_ = agg_switches_per_subtree_;
 }
 
+int
+TaperedFatTree::switchDistance(SwitchId src, SwitchId dst) const
+{
+  if (src == dst) return 0;
+
+  int src_lvl = level(src);
+  int dst_lvl = level(dst);
+  if (src_lvl > dst_lvl){
+    std::swap(src, dst);
+    std::swap(src_lvl, dst_lvl);
+  }
+  switch (src_lvl*3 + dst_lvl){
+  case 0: //leaf-leaf
+    return injSubtree(src) == injSubtree(dst) ? 2 : 4;
+  case 1: //leaf-agg
+    return injSubtree(src) == aggSubtree(dst) ? 1 : 3;
+  case 2: //leaf-core
+    return 2;
+  case 4: //agg-agg, through the core
+    return 2;
+  default: //agg-core
+    return 1;
+  }
+}
+
 void
 TaperedFatTree::connectedOutports(SwitchId src, std::vector<Connection>& conns) const
 {
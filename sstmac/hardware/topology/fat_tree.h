@@ -251,6 +251,8 @@ class FatTree :
     return minimalDistance(src/concentration_, dst/concentration_);
   }
 
+  int switchDistance(SwitchId src, SwitchId dst) const override;
+
  protected:
   // used for minimal_fat_tree routing
   inline int upPort(int level) const override {
@@ -276,7 +278,24 @@ class FatTree :
   double leaf_agg_bw_;
   double agg_core_bw_;
 
+  //when aggs and cores split into groups that are fully wired to each other,
+  //the group index of each core and agg switch - empty otherwise
+  std::vector<int> core_group_;
+  std::vector<int> agg_group_;
+
   void checkInput() const;
+
+  /**
+   * Fill core_group_ and agg_group_ if the wiring has a closed-form distance:
+   * leaves wired to every agg in their subtree, and every subtree
+   * having an agg in every group
+   */
+  void initCoreGroups();
+
+  int group(SwitchId sid) const {
+    return level(sid) == 1 ? agg_group_[sid - num_leaf_switches_]
+         : core_group_[sid - num_leaf_switches_ - num_agg_switches_];
+  }
 };
 
 
@@ -348,6 +367,8 @@ class TaperedFatTree : public AbstractFatTree
     return minimalDistance(src/concentration_, dst/concentration_);
   }
 
+  int switchDistance(SwitchId src, SwitchId dst) const override;
+
   void endpointsConnectedToInjectionSwitch(
       SwitchId swaddr, std::vector<InjectionPort>& nodes) const override;
 
@@ -64,7 +64,7 @@ FileTopology::FileTopology(SST::Params& params) :
       "file topology: failed to open file %s", fname.c_str());
   in >> json_;
 
-  num_hops_ = json_.at("avg_num_hops");
+  num_hops_ = json_.value("avg_num_hops", -1);
 
   // index the nodes
   nodes_ = json_.at("nodes");
@@ -87,6 +87,7 @@ FileTopology::FileTopology(SST::Params& params) :
 
   // loop through and analyze switch ports
   std::set<int> leafs;
+  node_to_switch_.resize(num_nodes_);
   maxNumPorts_ = 0;
   int max_node_ports = 0;
   for (auto it = switches_.begin(); it != switches_.end(); ++it) {
@@ -100,6 +101,7 @@ FileTopology::FileTopology(SST::Params& params) :
       auto nd = idmap_.find(prt->at("destination"));
       if( nd != idmap_.end() ) {
         leafs.insert(sid);
+        node_to_switch_[nd->second] = sid;
         ++node_ports;
       }
 
@@ -118,6 +120,9 @@ FileTopology::FileTopology(SST::Params& params) :
   // compute max number of ports (switch ports + node ports)
   // +2 because we start indexing at zero
   maxNumPorts_ += max_node_ports + 2;
+
+  // exact hop counts are looked up on every message, build them up front
+  if (num_hops_ < 0) distanceOracle();
 }
 
 void
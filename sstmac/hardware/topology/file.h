@@ -86,9 +86,8 @@ class FileTopology : public Topology
     return num_nodes_ - 1;
   }
 
-  SwitchId endpointToSwitch(NodeId) const override {
-    spkt_abort_printf("endpointToSwitch() not implemented");
-    return SwitchId(0);
+  SwitchId endpointToSwitch(NodeId nid) const override {
+    return node_to_switch_[nid];
   }
 
   SwitchId numLeafSwitches() const override {
@@ -96,13 +95,13 @@ class FileTopology : public Topology
   }
 
   int minimalDistance(SwitchId src, SwitchId dst) const {
-    spkt_abort_printf("minimalDistance() not implemented");
-    return 0;
+    return distanceOracle()->distance(src, dst);
   }
 
   int numHopsToNode(NodeId src, NodeId dst) const override {
-    // extremely approximate
-    return num_hops_;
+    //a file can give a fixed average instead of exact distances
+    if (num_hops_ >= 0) return num_hops_;
+    return minimalDistance(node_to_switch_[src], node_to_switch_[dst]);
   }
 
   void endpointsConnectedToEjectionSwitch(
@@ -173,6 +172,7 @@ class FileTopology : public Topology
   int num_leaf_switches_;
   int maxNumPorts_;
   int num_hops_;
+  std::vector<SwitchId> node_to_switch_;
   nlohmann::json json_;
   nlohmann::json switches_;
   nlohmann::json nodes_;
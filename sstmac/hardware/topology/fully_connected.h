@@ -89,6 +89,10 @@ class FullyConnected : public StructuredTopology
     return 1;
   }
 
+  int switchDistance(SwitchId src, SwitchId dst) const override {
+    return src == dst ? 0 : 1;
+  }
+
   int numHopsToNode(NodeId src, NodeId dst) const override {
     return 1;
   }
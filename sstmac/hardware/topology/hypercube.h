@@ -92,6 +92,11 @@ class Hypercube :
 
   int minimalDistance(SwitchId src, SwitchId dst) const;
 
+  int switchDistance(SwitchId src, SwitchId dst) const override {
+    //every dimension is all-to-all
+    return minimalDistance(src, dst);
+  }
+
   int numHopsToNode(NodeId src, NodeId dst) const override {
     return minimalDistance(src/concentration_, dst/concentration_);
   }
@@ -51,6 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
 #include <fstream>
+#include <algorithm>
 
 #if SSTMAC_INTEGRATED_SST_CORE && SSTMAC_HAVE_VALID_MPI
 #include <mpi.h>
@@ -71,6 +72,8 @@ RegisterKeywords(
 { "network_nodes_per_switch", "DEPRECATED: the number of nodes per switch" },
 { "auto", "whether to auto-generate topology based on app size"},
 { "output_graph", "enable dot format topology graph generation by specifying an output filename"},
+{ "distance_file", "file to read or write cached all-pairs switch distances"},
+{ "verify_distances", "check closed-form switch distances against a search of the links"},
 );
 
 RegisterDebugSlot(topology,
@@ -103,7 +106,8 @@ Topology::nodeToLogpSwitch(NodeId nid) const
 }
 #endif
 
-Topology::Topology(SST::Params& params)
+Topology::Topology(SST::Params& params) :
+  oracle_(nullptr)
 {
 #if SSTMAC_INTEGRATED_SST_CORE
 #if SSTMAC_HAVE_VALID_MPI
@@ -116,10 +120,13 @@ Topology::Topology(SST::Params& params)
 
   dot_file_ = params.find<std::string>("output_graph", "");
   xyz_file_ = params.find<std::string>("outputXYZ", "");
+  distance_file_ = params.find<std::string>("distance_file", "");
+  verify_distances_ = params.find<bool>("verify_distances", false);
 }
 
 Topology::~Topology()
 {
+  delete oracle_.load();
 }
 
 Topology*
@@ -129,10 +136,191 @@ Topology::staticTopology(SST::Params& params)
     SST::Params top_params = params.find_scoped_params("topology");
     staticTopology_ = sprockit::create<Topology>(
       "macro", top_params.find<std::string>("name"), top_params);
+    if (staticTopology_->verify_distances_){
+      staticTopology_->checkSwitchDistances();
+    }
   }
   return staticTopology_;
 }
 
+const DistanceOracle*
+Topology::distanceOracle() const
+{
+  //only the first call pays for synchronization
+  const DistanceOracle* oracle = oracle_.load(std::memory_order_acquire);
+  if (!oracle){
+    std::call_once(oracle_built_, [this]{
+      oracle_.store(new DistanceOracle(this, distance_file_), std::memory_order_release);
+    });
+    oracle = oracle_.load(std::memory_order_acquire);
+  }
+  return oracle;
+}
+
+void
+Topology::checkSwitchDistances() const
+{
+  DistanceOracle searched(this);
+  SwitchId nswitches = numSwitches();
+  for (SwitchId src=0; src < nswitches; ++src){
+    for (SwitchId dst=0; dst < nswitches; ++dst){
+      int expected = searched.distance(src, dst);
+      int computed = switchDistance(src, dst);
+      if (computed != expected){
+        spkt_abort_printf("%s gives switch distance %d from %d to %d, but the links give %d",
+                          toString().c_str(), computed, int(src), int(dst), expected);
+      }
+    }
+  }
+}
+
+DistanceOracle::DistanceOracle(const Topology* top, const std::string& cache_file) :
+  num_switches_(top->numSwitches()),
+  bits_(4)
+{
+  //FNV-1a over the links, so a cached table is never used for a different network
+  uint64_t fingerprint = 14695981039346656037ULL;
+  auto mix = [&](uint32_t x){
+    for (int i=0; i < 4; ++i){
+      fingerprint = (fingerprint ^ ((x >> (8*i)) & 0xFF)) * 1099511628211ULL;
+    }
+  };
+  std::vector<std::vector<SwitchId>> neighbors(num_switches_);
+  std::vector<Topology::Connection> conns;
+  for (SwitchId sid=0; sid < num_switches_; ++sid){
+    top->connectedOutports(sid, conns);
+    mix(conns.size());
+    for (auto& conn : conns){
+      neighbors[sid].push_back(conn.dst);
+      mix(conn.dst);
+    }
+  }
+
+  if (!cache_file.empty() && readFile(cache_file, fingerprint)){
+    return;
+  }
+  build(neighbors);
+  if (!cache_file.empty()){
+    writeFile(cache_file, fingerprint);
+  }
+}
+
+void
+DistanceOracle::build(const std::vector<std::vector<SwitchId>>& neighbors)
+{
+  //BFS from every switch, packing each row as soon as it is done.
+  //Start with 4 bits per entry and widen if the diameter turns out larger.
+  uint64_t num_entries = uint64_t(num_switches_)*num_switches_;
+  bits_ = 4;
+  packed_.assign((num_entries + 1) / 2, 0);
+  std::vector<uint8_t> row(num_switches_);
+  std::vector<SwitchId> frontier;
+  std::vector<SwitchId> next;
+  for (SwitchId src=0; src < num_switches_; ++src){
+    std::fill(row.begin(), row.end(), 255);
+    row[src] = 0;
+    frontier.clear();
+    frontier.push_back(src);
+    int depth = 0;
+    int max_dist = 0;
+    while (!frontier.empty()){
+      ++depth;
+      if (depth >= 255){
+        spkt_abort_printf("distance oracle: switch distances of %d or more are not supported", depth);
+      }
+      next.clear();
+      for (SwitchId sw : frontier){
+        for (SwitchId nbr : neighbors[sw]){
+          if (row[nbr] == 255){
+            row[nbr] = depth;
+            next.push_back(nbr);
+          }
+        }
+      }
+      if (!next.empty()) max_dist = depth;
+      frontier.swap(next);
+    }
+
+    if (bits_ == 4 && max_dist >= 15){
+      widen();
+    }
+
+    uint64_t offset = uint64_t(src)*num_switches_;
+    for (SwitchId dst=0; dst < num_switches_; ++dst){
+      uint8_t d = row[dst] == 255 ? unreachable() : row[dst];
+      uint64_t idx = offset + dst;
+      if (bits_ == 4){
+        packed_[idx/2] |= d << ((idx%2)*4);
+      } else {
+        packed_[idx] = d;
+      }
+    }
+  }
+  top_debug("distance oracle: built %d x %d table with %d bits per entry",
+            int(num_switches_), int(num_switches_), bits_);
+}
+
+void
+DistanceOracle::widen()
+{
+  uint64_t num_entries = uint64_t(num_switches_)*num_switches_;
+  std::vector<uint8_t> wide(num_entries);
+  for (uint64_t i=0; i < num_entries; ++i){
+    uint8_t d = (packed_[i/2] >> ((i%2)*4)) & 0xF;
+    wide[i] = d == 0xF ? 0xFF : d;
+  }
+  packed_.swap(wide);
+  bits_ = 8;
+}
+
+static const char distance_file_magic[8] = {'S','S','T','M','D','S','T','2'};
+
+bool
+DistanceOracle::readFile(const std::string& fname, uint64_t fingerprint)
+{
+  std::ifstream in(fname, std::ios::binary);
+  if (!in.is_open()) return false;
+
+  char magic[8];
+  uint64_t file_fingerprint;
+  uint32_t num_switches;
+  int32_t bits;
+  in.read(magic, sizeof(magic));
+  in.read((char*)&file_fingerprint, sizeof(file_fingerprint));
+  in.read((char*)&num_switches, sizeof(num_switches));
+  in.read((char*)&bits, sizeof(bits));
+  if (!in || !std::equal(magic, magic + sizeof(magic), distance_file_magic)
+      || file_fingerprint != fingerprint
+      || num_switches != num_switches_ || (bits != 4 && bits != 8)){
+    top_debug("distance oracle: %s does not match this topology, rebuilding it",
+              fname.c_str());
+    return false;
+  }
+
+  uint64_t num_entries = uint64_t(num_switches_)*num_switches_;
+  packed_.resize(bits == 4 ? (num_entries + 1) / 2 : num_entries);
+  in.read((char*)packed_.data(), packed_.size());
+  if (!in) return false;
+
+  bits_ = bits;
+  return true;
+}
+
+void
+DistanceOracle::writeFile(const std::string& fname, uint64_t fingerprint) const
+{
+  std::ofstream out(fname, std::ios::binary);
+  if (!out.is_open()){
+    spkt_abort_printf("distance oracle: could not open %s for writing", fname.c_str());
+  }
+  int32_t bits = bits_;
+  out.write(distance_file_magic, sizeof(distance_file_magic));
+  out.write((const char*)&fingerprint, sizeof(fingerprint));
+  out.write((const char*)&num_switches_, sizeof(num_switches_));
+  out.write((const char*)&bits, sizeof(bits));
+  out.write((const char*)packed_.data(), packed_.size());
+}
+
 std::string
 Topology::getPortNamespace(int port)
 {
@@ -58,7 +58,11 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/factory.h>
 #include <sprockit/errors.h>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
 #include <cmath>
+#include <atomic>
+#include <mutex>
 
 DeclareDebugSlot(topology)
 
@@ -68,6 +72,66 @@ DeclareDebugSlot(topology)
 namespace sstmac {
 namespace hw {
 
+/**
+ * @class DistanceOracle
+ * Hop counts between every pair of switches, computed once by BFS over
+ * Topology::connectedOutports(). Entries are packed 4 bits apiece when
+ * the diameter allows it and 8 bits otherwise. The table can be saved
+ * to a file and reloaded so large networks only pay for the BFS once.
+ * Saved tables carry a fingerprint of the links they were built from.
+ */
+class DistanceOracle
+{
+ public:
+  /**
+   * @param top
+   * @param cache_file If not empty, read the table from here if it matches
+   *                   the topology, otherwise build it and write it here
+   */
+  DistanceOracle(const Topology* top, const std::string& cache_file = "");
+
+  /**
+   * @return The minimal number of hops from src to dst, -1 if unreachable
+   */
+  int distance(SwitchId src, SwitchId dst) const {
+    uint64_t idx = uint64_t(src) * num_switches_ + dst;
+    int d;
+    if (bits_ == 4){
+      d = (packed_[idx/2] >> ((idx%2)*4)) & 0xF;
+    } else {
+      d = packed_[idx];
+    }
+    return d == unreachable() ? -1 : d;
+  }
+
+  int numSwitches() const {
+    return num_switches_;
+  }
+
+ private:
+  void build(const std::vector<std::vector<SwitchId>>& neighbors);
+
+  /**
+   * Switch from 4 to 8 bits per entry once a distance needs it
+   */
+  void widen();
+
+  /**
+   * @return Whether a table matching this topology was read
+   */
+  bool readFile(const std::string& fname, uint64_t fingerprint);
+
+  void writeFile(const std::string& fname, uint64_t fingerprint) const;
+
+  int unreachable() const {
+    return (1 << bits_) - 1;
+  }
+
+  std::vector<uint8_t> packed_;
+  uint32_t num_switches_;
+  int bits_;
+};
+
 class Topology : public sprockit::printable
 {
  public:
@@ -384,6 +448,32 @@ class Topology : public sprockit::printable
   */
   virtual int numHopsToNode(NodeId src, NodeId dst) const = 0;
 
+  /**
+   * @brief distanceOracle
+   * All-pairs switch distances for topologies without a closed form.
+   * Built once, on first use, and shared by every component. If topology.distance_file
+   * is given, the table is read from there or written there after it is built.
+   * @return The cached oracle
+   */
+  const DistanceOracle* distanceOracle() const;
+
+  /**
+   * @brief switchDistance
+   * Topologies with a closed form override this so that no all-pairs table is built.
+   * @return The minimal number of hops from switch src to switch dst,
+   *         following the links given by connectedOutports()
+   */
+  virtual int switchDistance(SwitchId src, SwitchId dst) const {
+    return distanceOracle()->distance(src, dst);
+  }
+
+  /**
+   * @brief checkSwitchDistances
+   * Abort if switchDistance() disagrees with a search over connectedOutports()
+   * for any pair of switches. Run when topology.verify_distances is set.
+   */
+  void checkSwitchDistances() const;
+
   virtual SwitchId endpointToSwitch(NodeId) const = 0;
 
   /**
@@ -512,6 +602,10 @@ class Topology : public sprockit::printable
   static Topology* staticTopology_;
   std::string dot_file_;
   std::string xyz_file_;
+  std::string distance_file_;
+  bool verify_distances_;
+  mutable std::atomic<DistanceOracle*> oracle_;
+  mutable std::once_flag oracle_built_;
 };
 
 static inline std::ostream& operator<<(std::ostream& os, const Topology::xyz& v) {
@@ -127,6 +127,21 @@ Torus::minimalDistance(
   return dist;
 }
 
+int
+Torus::switchDistance(SwitchId src, SwitchId dst) const
+{
+  int div = 1;
+  int ndim = dimensions_.size();
+  int dist = 0;
+  for (int i=0; i < ndim; ++i){
+    int srcX = (src / div) % dimensions_[i];
+    int dstX = (dst / div) % dimensions_[i];
+    dist += shortestDistance(i, srcX, dstX);
+    div *= dimensions_[i];
+  }
+  return dist;
+}
+
 bool
 Torus::shortestPathPositive(
   int dim, int src, int dst) const
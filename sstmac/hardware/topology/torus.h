@@ -120,6 +120,8 @@ class Torus : public CartesianTopology
 
   int minimalDistance(SwitchId sid, SwitchId dst) const;
 
+  int switchDistance(SwitchId src, SwitchId dst) const override;
+
   int numHopsToNode(NodeId src, NodeId dst) const override {
     return minimalDistance(src / concentration_, dst / concentration_);
   }
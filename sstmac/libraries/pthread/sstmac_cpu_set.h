@@ -47,13 +47,16 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <stdint.h>
 
+#define SSTMAC_CPU_SETSIZE 1024
+#define SSTMAC_CPU_SETWORDS (SSTMAC_CPU_SETSIZE/64)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct
 {
-  uint64_t cpubits;
+  uint64_t cpubits[SSTMAC_CPU_SETWORDS];
 } sstmac_cpu_set_t;
 
 #ifdef __cplusplus
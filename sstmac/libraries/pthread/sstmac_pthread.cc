@@ -234,12 +234,7 @@ SSTMAC_pthread_mutex_destroy(sstmac_pthread_mutex_t * mutex)
   Thread* thr = currentThread();
   App* a = thr->parentApp();
   bool found = a->eraseMutex(*mutex);
-  if (found){
-    return EINVAL;
-  } else {
-    return 0;
-  }
-
+  return found ? 0 : EINVAL;
 }
 
 static int
@@ -272,12 +267,8 @@ SSTMAC_pthread_mutex_lock(sstmac_pthread_mutex_t* mutex)
   mutex_t* mut = thr->parentApp()->getMutex(*mutex);
   if (mut == 0){
     return EINVAL;
-  } else if (mut->locked) {
-    mut->waiters.push_back(thr);
-    thr->os()->block();
-  } else {
-    mut->locked = true;
   }
+  mut->lock(thr);
   return 0;
 }
 
@@ -301,11 +292,8 @@ SSTMAC_pthread_mutex_trylock(sstmac_pthread_mutex_t * mutex)
   mutex_t* mut = thr->parentApp()->getMutex(*mutex);
   if (mut == nullptr){
     return EINVAL;
-  } else if (mut->locked){
-    return 1;
-  } else {
-    return 0;
   }
+  return mut->tryLock() ? 0 : EBUSY;
 }
 
 extern "C" int
@@ -327,38 +315,11 @@ SSTMAC_pthread_mutex_unlock(sstmac_pthread_mutex_t * mutex)
   mutex_t* mut = thr->parentApp()->getMutex(*mutex);
   if (mut == 0 || !mut->locked){
     return EINVAL;
-  } else if (!mut->waiters.empty()){
-    Thread* blocker = mut->waiters.front();
-    mut->waiters.pop_front();
-    thr->os()->unblock(blocker);
-  } else {
-    mut->locked = false;
   }
+  mut->unlock(thr);
   return 0;
 }
 
-class UnblockEvent : public ExecutionEvent
-{
- public:
-  UnblockEvent(mutex_t* mut, OperatingSystem* os)
-    : mutex_(mut),
-    os_(os)
-  {
-  }
-
-  void execute(){
-    Thread* blocker = mutex_->waiters.front();
-    mutex_->waiters.pop_front();
-    os_->unblock(blocker);
-  }
-
- protected:
-  mutex_t* mutex_;
-
-  OperatingSystem* os_;
-
-};
-
 
 extern "C" int
 SSTMAC_pthread_mutexattr_init(sstmac_pthread_mutexattr_t *attr)
@@ -435,42 +396,69 @@ SSTMAC_pthread_cond_timedwait(sstmac_pthread_cond_t * cond,
     return EINVAL;
   }
 
+  if (!mut->locked){
+    return EINVAL;
+  }
+
   OperatingSystem* myos = thr->os();
-  (*pending)[*mutex] = mut;
-  if (!mut->waiters.empty()){
-    myos->sendExecutionEventNow(new UnblockEvent(mut, myos));
-  } else {
-    //unlock - nobody waiting on this
-    mut->locked = false;
+  Timestamp delay;
+  if (abstime){
+    //abstime is on the same simulated clock gettimeofday reports
+    GlobalTimestamp deadline(abstime->tv_sec + 1e-9*abstime->tv_nsec);
+    GlobalTimestamp now = myos->now();
+    if (deadline <= now){
+      return ETIMEDOUT;
+    }
+    delay = deadline - now;
   }
-  mut->conditionals.push_back(thr);
+
+  pending->waiters.emplace_back(thr, mut);
+  mut->unlock(thr);
 
   if (abstime){
-    //schedule a timed wait unblock
-    double secs = abstime->tv_sec + 1e-9*abstime->tv_nsec;
-    Timestamp delay(secs);
-    //this key may be used to unblock twice
-    //if it does, make sure it doesn't get deleted
     myos->blockTimeout(delay);
   } else {
     myos->block();
   }
 
   if (abstime && thr->timedOut()){
-    //the cond signal never fired, remove myself from the list
-    //delete the key and move on
-    auto end = mut->conditionals.end();
-    for (auto it=mut->conditionals.begin(); it != end; ++it){
-      Thread* next = *it;
-      if (next == thr){
-        mut->conditionals.erase(it);
-        break;
+    //never signaled - still queued on the condition
+    for (auto it=pending->waiters.begin(); it != pending->waiters.end(); ++it){
+      if (it->first == thr){
+        pending->waiters.erase(it);
+        mut->lock(thr);
+        return ETIMEDOUT;
       }
     }
+    //signaled while the mutex was held - queued on the mutex instead
+    for (auto it=mut->waiters.begin(); it != mut->waiters.end(); ++it){
+      if (*it == thr){
+        mut->waiters.erase(it);
+        mut->lock(thr);
+        return 0;
+      }
+    }
+    //the mutex was already handed to us
   }
   return 0;
 }
 
+/**
+ * Wake a condition waiter. If the mutex is free, the waiter gets it directly.
+ * If the mutex is held, the waiter is moved onto the mutex queue instead of
+ * being woken only to block again (wait morphing).
+ */
+static void
+wake_cond_waiter(Thread* signaler, Thread* waiter, mutex_t* mut)
+{
+  if (mut->locked){
+    mut->waiters.push_back(waiter);
+  } else {
+    mut->locked = true;
+    signaler->os()->unblock(waiter);
+  }
+}
+
 extern "C" int
 SSTMAC_pthread_cond_signal(sstmac_pthread_cond_t * cond)
 {
@@ -485,17 +473,10 @@ SSTMAC_pthread_cond_signal(sstmac_pthread_cond_t * cond)
   if (pending == 0){
     return EINVAL;
   }
-  condition_t::iterator it, end = pending->end();
-  OperatingSystem* myos = thr->os();
-  for (it=pending->begin(); it != end; ++it){
-    mutex_t* mut = it->second;
-    if (mut->conditionals.empty()){
-        sprockit::abort("pthread::mutex signaled, but there are no waiting threads");
-    }
-    Thread* thr = mut->conditionals.front();
-    mut->conditionals.pop_front();
-    mut->locked = true;
-    myos->unblock(thr);
+  if (!pending->waiters.empty()){
+    auto next = pending->waiters.front();
+    pending->waiters.pop_front();
+    wake_cond_waiter(thr, next.first, next.second);
   }
   return 0;
 }
@@ -503,9 +484,23 @@ SSTMAC_pthread_cond_signal(sstmac_pthread_cond_t * cond)
 extern "C" int
 SSTMAC_pthread_cond_broadcast(sstmac_pthread_cond_t * cond)
 {
-  pthread_debug("pthread_cond_broadcast");  
-  spkt_throw_printf(sprockit::UnimplementedError,
-                   "pthread::pthread_cond_broadcast not implemented");
+  pthread_debug("pthread_cond_broadcast");
+  int rc;
+  if ((rc=check_cond(cond)) != 0){
+    return rc;
+  }
+
+  Thread* thr = currentThread();
+  condition_t* pending = thr->parentApp()->getCondition(*cond);
+  if (pending == 0){
+    return EINVAL;
+  }
+  std::list<std::pair<Thread*,mutex_t*>> waiters;
+  waiters.swap(pending->waiters);
+  for (auto& next : waiters){
+    wake_cond_waiter(thr, next.first, next.second);
+  }
+  return 0;
 }
 
 extern "C" int
@@ -600,8 +595,7 @@ extern "C" int
 SSTMAC_pthread_attr_init(sstmac_pthread_attr_t *attr)
 {
   //set all cpus to possibly active
-  attr->cpumask = 0;
-  attr->cpumask = ~(attr->cpumask);
+  sstmac::sw::CpuMask::all().toCpuSet(&attr->cpumask);
   attr->detach_state = SSTMAC_PTHREAD_CREATE_JOINABLE;
   return 0;
 }
@@ -615,14 +609,14 @@ SSTMAC_pthread_attr_destroy(sstmac_pthread_attr_t *attr)
 extern "C" int
 SSTMAC_pthread_attr_setaffinity_np(sstmac_pthread_attr_t *attr, size_t cpusetsize, const sstmac_cpu_set_t *cpuset)
 {
-  attr->cpumask = cpuset->cpubits;
+  attr->cpumask = *cpuset;
   return 0;
 }
 
 extern "C" int
 SSTMAC_pthread_attr_getaffinity_np(sstmac_pthread_attr_t attr, size_t cpusetsize, sstmac_cpu_set_t *cpuset)
 {
-  cpuset->cpubits = attr.cpumask;
+  *cpuset = attr.cpumask;
   return 0;
 }
 
@@ -97,7 +97,7 @@ extern "C"
 #endif
 
 typedef struct {
-  uint64_t cpumask;
+  sstmac_cpu_set_t cpumask;
   int detach_state;
 } sstmac_pthread_attr_t;
 
@@ -46,6 +46,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/libraries/pthread/sstmac_sched.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
+#include <sstmac/software/process/cpu_mask.h>
 
 /* Set scheduling parameters for a process.  */
 extern "C" int
@@ -90,69 +91,80 @@ SSTMAC_sched_rr_get_interval (pid_t pid, struct timespec *t){
   return 0;
 }
 
+static void
+SSTMAC_check_setsize(const char* fxn, size_t setsize){
+  if (setsize > sizeof(sstmac_cpu_set_t)){
+    spkt_abort_printf("%s: invalid cpu setsize %lu", fxn, setsize);
+  }
+}
+
+static void
+SSTMAC_check_cpu(const char* fxn, int cpu, size_t setsize){
+  SSTMAC_check_setsize(fxn, setsize);
+  if (cpu < 0 || cpu >= SSTMAC_CPU_SETSIZE){
+    spkt_abort_printf("%s: cpu %d out of range - at most %d cpus supported",
+                      fxn, cpu, SSTMAC_CPU_SETSIZE);
+  }
+}
+
+static inline uint64_t
+SSTMAC_cpu_bit(int cpu){
+  return uint64_t(1) << (cpu % 64);
+}
+
 extern "C" void
 SSTMAC_CPU_SET_S (int cpu, size_t setsize, sstmac_cpu_set_t* cpusetp){
-  if (setsize > SSTMAC_CPU_SETSIZE){
-    spkt_abort_printf("SSTMAC_CPU_SET: invalid cpu setsize %lu", setsize);
-  }
-  cpusetp->cpubits = cpusetp->cpubits | (1<<cpu);
+  SSTMAC_check_cpu("SSTMAC_CPU_SET", cpu, setsize);
+  cpusetp->cpubits[cpu/64] |= SSTMAC_cpu_bit(cpu);
 }
 
 extern "C" void
 SSTMAC_CPU_CLR_S (int cpu, size_t setsize, sstmac_cpu_set_t* cpusetp){
-  if (setsize > SSTMAC_CPU_SETSIZE){
-    spkt_abort_printf("SSTMAC_CPU_CLR: invalid cpu setsize %lu", setsize);
-  }
-  cpusetp->cpubits = cpusetp->cpubits & ~(1<<cpu);
+  SSTMAC_check_cpu("SSTMAC_CPU_CLR", cpu, setsize);
+  cpusetp->cpubits[cpu/64] &= ~SSTMAC_cpu_bit(cpu);
 }
 
 extern "C" int
 SSTMAC_CPU_ISSET_S (int cpu, size_t setsize, sstmac_cpu_set_t* cpusetp){
-  return cpusetp->cpubits & (1<<cpu);
+  SSTMAC_check_cpu("SSTMAC_CPU_ISSET", cpu, setsize);
+  return (cpusetp->cpubits[cpu/64] & SSTMAC_cpu_bit(cpu)) != 0;
 }
 
 extern "C" void
 SSTMAC_CPU_ZERO_S (size_t setsize, sstmac_cpu_set_t* cpusetp){
-  if (setsize > SSTMAC_CPU_SETSIZE){
-    spkt_abort_printf("SSTMAC_CPU_CLR: invalid cpu setsize %lu", setsize);
-  }
-  cpusetp->cpubits = 0;
-}
-
-static int
-SSTMAC_count_bits(sstmac_cpu_set_t* cpusetp){
-  int count = 0;
-  for (int i=0; i < SSTMAC_CPU_SETSIZE; ++i){
-    if (cpusetp->cpubits & (1<<i)){
-      ++count;
-    }
-  }
-  return count;
+  SSTMAC_check_setsize("SSTMAC_CPU_ZERO", setsize);
+  for (int w=0; w < SSTMAC_CPU_SETWORDS; ++w) cpusetp->cpubits[w] = 0;
 }
 
 extern "C" int
 SSTMAC_CPU_COUNT_S (size_t setsize, sstmac_cpu_set_t* cpusetp){
-  return SSTMAC_count_bits(cpusetp);
+  return sstmac::sw::CpuMask(*cpusetp).count();
 }
 
 extern "C" int
 SSTMAC_CPU_EQUAL_S(size_t setsize, sstmac_cpu_set_t* cpusetp1, sstmac_cpu_set_t* cpusetp2){
-  return cpusetp1->cpubits == cpusetp1->cpubits;
+  return sstmac::sw::CpuMask(*cpusetp1) == sstmac::sw::CpuMask(*cpusetp2);
 }
 
 extern "C" void
 SSTMAC_CPU_AND_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2){
-  destset->cpubits = srcset1->cpubits & srcset2->cpubits;
+  for (int w=0; w < SSTMAC_CPU_SETWORDS; ++w){
+    destset->cpubits[w] = srcset1->cpubits[w] & srcset2->cpubits[w];
+  }
 }
 
 extern "C" void
 SSTMAC_CPU_OR_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2){
-  destset->cpubits = srcset1->cpubits | srcset2->cpubits;
+  for (int w=0; w < SSTMAC_CPU_SETWORDS; ++w){
+    destset->cpubits[w] = srcset1->cpubits[w] | srcset2->cpubits[w];
+  }
 }
 
 extern "C" void
 SSTMAC_CPU_XOR_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2){
-  destset->cpubits = srcset1->cpubits ^ srcset2->cpubits;
+  for (int w=0; w < SSTMAC_CPU_SETWORDS; ++w){
+    destset->cpubits[w] = srcset1->cpubits[w] ^ srcset2->cpubits[w];
+  }
 }
 
 extern "C" sstmac_cpu_set_t*
@@ -173,13 +185,8 @@ extern "C" int
 SSTMAC_sched_setaffinity (pid_t pid, size_t cpusetsize, const sstmac_cpu_set_t *cpuset){
   sstmac::sw::OperatingSystem* os = sstmac::sw::OperatingSystem::currentOs();
   sstmac::sw::Thread* t = os->activeThread();
-  t->setCpumask(cpuset->cpubits);
-
-  uint64_t test_mask = cpuset->cpubits & t->activeCoreMask();
-  if (test_mask != t->activeCoreMask()){
-    //the currently active thread is running on cores not part of its current affinity map
-    os->reassign_cores(t);
-  }
+  //setCpumask moves the thread off any active cores outside the new affinity
+  t->setCpumask(*cpuset);
   return 0;
 }
 
@@ -187,6 +194,6 @@ SSTMAC_sched_setaffinity (pid_t pid, size_t cpusetsize, const sstmac_cpu_set_t *
 extern "C" int
 SSTMAC_sched_getaffinity (pid_t pid, size_t cpusetsize, sstmac_cpu_set_t *cpuset){
   sstmac::sw::Thread* t = sstmac::sw::OperatingSystem::currentThread();
-  cpuset->cpubits = t->cpumask();
+  t->cpumask().toCpuSet(cpuset);
   return 0;
 }
@@ -85,13 +85,11 @@ static inline int SSTMAC_sched_get_priority_min (int algorithm){
 /* Get the SCHED_RR interval for the named process.  */
 extern int SSTMAC_sched_rr_get_interval (pid_t pid, struct timespec *t);
 
-# define SSTMAC_CPU_SETSIZE 64
-
-# define SSTMAC_CPU_SET(cpu, cpusetp)   SSTMAC_CPU_SET_S(cpu, 64, cpusetp)
-# define SSTMAC_CPU_CLR(cpu, cpusetp)   SSTMAC_CPU_CLR_S(cpu, 64, cpusetp)
-# define SSTMAC_CPU_ISSET(cpu, cpusetp) SSTMAC_CPU_ISSET_S(cpu, 64, cpusetp)
-# define SSTMAC_CPU_ZERO(cpusetp)       SSTMAC_CPU_ZERO_S(64, cpusetp)
-# define SSTMAC_CPU_COUNT(cpusetp)      SSTMAC_CPU_COUNT_S(64, cpusetp)
+# define SSTMAC_CPU_SET(cpu, cpusetp)   SSTMAC_CPU_SET_S(cpu, sizeof(sstmac_cpu_set_t), cpusetp)
+# define SSTMAC_CPU_CLR(cpu, cpusetp)   SSTMAC_CPU_CLR_S(cpu, sizeof(sstmac_cpu_set_t), cpusetp)
+# define SSTMAC_CPU_ISSET(cpu, cpusetp) SSTMAC_CPU_ISSET_S(cpu, sizeof(sstmac_cpu_set_t), cpusetp)
+# define SSTMAC_CPU_ZERO(cpusetp)       SSTMAC_CPU_ZERO_S(sizeof(sstmac_cpu_set_t), cpusetp)
+# define SSTMAC_CPU_COUNT(cpusetp)      SSTMAC_CPU_COUNT_S(sizeof(sstmac_cpu_set_t), cpusetp)
 
 void  SSTMAC_CPU_SET_S (int cpu, size_t setsize, sstmac_cpu_set_t* cpusetp);
 void  SSTMAC_CPU_CLR_S (int cpu, size_t setsize, sstmac_cpu_set_t* cpusetp);
@@ -99,18 +97,18 @@ int   SSTMAC_CPU_ISSET_S (int cpu, size_t setsize, sstmac_cpu_set_t*);
 void  SSTMAC_CPU_ZERO_S (size_t setsize, sstmac_cpu_set_t* cpusetp);
 int   SSTMAC_CPU_COUNT_S (size_t setsize, sstmac_cpu_set_t* cpusetp);
 
-#define SSTMAC_CPU_EQUAL(cpusetp1, cpusetp2) SSTMAC_CPU_EQUAL_S(64, cpusetp1, cpusetp2)
+#define SSTMAC_CPU_EQUAL(cpusetp1, cpusetp2) SSTMAC_CPU_EQUAL_S(sizeof(sstmac_cpu_set_t), cpusetp1, cpusetp2)
 int SSTMAC_CPU_EQUAL_S(size_t setsize, sstmac_cpu_set_t* cpusetp1, sstmac_cpu_set_t* cpusetp2);
 
-# define SSTMAC_CPU_AND(destset, srcset1, srcset2) SSTMAC_CPU_AND_S(destset, 64, srcset1, srcset2)
-# define SSTMAC_CPU_OR(destset, srcset1, srcset2)  SSTMAC_CPU_OR_S(destset, 64, srcset1, srcset2)
-# define SSTMAC_CPU_XOR(destset, srcset1, srcset2) SSTMAC_CPU_XOR_S(destset, 64, srcset1, srcset2)
+# define SSTMAC_CPU_AND(destset, srcset1, srcset2) SSTMAC_CPU_AND_S(sizeof(sstmac_cpu_set_t), destset, srcset1, srcset2)
+# define SSTMAC_CPU_OR(destset, srcset1, srcset2)  SSTMAC_CPU_OR_S(sizeof(sstmac_cpu_set_t), destset, srcset1, srcset2)
+# define SSTMAC_CPU_XOR(destset, srcset1, srcset2) SSTMAC_CPU_XOR_S(sizeof(sstmac_cpu_set_t), destset, srcset1, srcset2)
 
 void SSTMAC_CPU_AND_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2);
 void SSTMAC_CPU_OR_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2);
 void SSTMAC_CPU_XOR_S(size_t setsize, sstmac_cpu_set_t* destset, sstmac_cpu_set_t* srcset1, sstmac_cpu_set_t* srcset2);
 
-# define SSTMAC_CPU_ALLOC_SIZE(count) (1<<count)
+# define SSTMAC_CPU_ALLOC_SIZE(count) sizeof(sstmac_cpu_set_t)
 sstmac_cpu_set_t* SSTMAC_CPU_ALLOC(int count);
 void SSTMAC_CPU_FREE(sstmac_cpu_set_t* cpuset);
 
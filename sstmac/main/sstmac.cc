@@ -62,6 +62,9 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/app.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/time.h>
+#include <sstmac/software/threading/stack_alloc.h>
+#include <sstmac/software/process/global.h>
+#include <sstmac/software/process/memoize_db.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/topology/topology.h>
 #include <sprockit/fileio.h>
@@ -421,6 +424,7 @@ tryMain(sprockit::SimParameters::ptr params,
     cerr0 << std::string(argv[0]) << "\n" << oo << std::endl;
   }
   sstmac::run(oo, rt, mainParams, stats);
+  sstmac::sw::MemoizeDatabase::write(rt ? rt->me() : 0, rt ? rt->nproc() : 1);
 
 
   if (oo.low_res_timer){
@@ -429,6 +433,10 @@ tryMain(sprockit::SimParameters::ptr params,
     cout0 << sprockit::printf("Estimated total runtime of %20.8f seconds\n", stats.simulatedTime);
   }
 
+  sstmac::sw::StackAlloc::printUsage(cout0);
+  sstmac::GlobalVariable::glblCtx.printUsage("globals", cout0);
+  sstmac::GlobalVariable::tlsCtx.printUsage("thread-locals", cout0);
+
   if (oo.print_params) {
     params->printParams();
   }
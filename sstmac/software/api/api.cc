@@ -89,12 +89,12 @@ API::activeThread()
 }
 
 void
-API::startAPICall()
+API::startAPICall(bool cheap)
 {
   if (host_timer_){
     host_timer_->start();
   }
-  activeThread()->startAPICall();
+  activeThread()->startAPICall(cheap);
 }
 void
 API::endAPICall()
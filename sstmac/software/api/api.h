@@ -102,8 +102,10 @@ class API
    * Enter a call such as MPI_Send. Any perf counters or time counters
    * collected since the last API call can then advance time or
    * increment statistics.
+   * @param cheap Whether the call neither communicates nor blocks.
+   *        Host-timed compute can then stay batched across it.
    */
-  void startAPICall();
+  void startAPICall(bool cheap = false);
 
   /**
    * @brief end_api_call
@@ -44,10 +44,22 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/software/launch/first_available_allocation.h>
 #include <sstmac/hardware/topology/topology.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+
+RegisterKeywords(
+{ "contiguous", "whether the allocated nodes must be a single contiguous block of node ids" },
+);
 
 namespace sstmac {
 namespace sw {
 
+FirstAvailableAllocation::FirstAvailableAllocation(SST::Params& params) :
+  NodeAllocator(params)
+{
+  contiguous_ = params.find<bool>("contiguous", false);
+}
+
 FirstAvailableAllocation::~FirstAvailableAllocation() throw ()
 {
 }
@@ -58,19 +70,29 @@ FirstAvailableAllocation::allocate(
   const ordered_node_set& available,
   ordered_node_set& allocation) const
 {
-  if (available.size() < nnode_requested) return false;
+  if (int(available.size()) < nnode_requested) return false;
 
-  int nid = 0;
+  if (contiguous_){
+    NodeId start = available.findContiguous(nnode_requested);
+    if (start == ordered_node_set::npos) return false;
+    for (int i=0; i < nnode_requested; ++i){
+      allocation.insert(start + i);
+    }
+    debug_printf(sprockit::dbg::allocation,
+        "first_available_allocation: contiguous nodes %d-%d",
+        int(start), int(start) + nnode_requested - 1);
+    return true;
+  }
+
+  NodeId nid = available.next(0);
   int num_allocated = 0;
   while (num_allocated < nnode_requested){
-    if (available.find(nid) != available.end()){
-      allocation.insert(nid);
-      debug_printf(sprockit::dbg::allocation,
-          "first_available_allocation: node[%d]=%d",
-          num_allocated, nid);
-      ++num_allocated;
-    }
-    ++nid;
+    allocation.insert(nid);
+    debug_printf(sprockit::dbg::allocation,
+        "first_available_allocation: node[%d]=%d",
+        num_allocated, nid);
+    ++num_allocated;
+    nid = available.next(nid + 1);
   }
 
   return true;
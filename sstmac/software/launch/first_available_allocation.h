@@ -63,10 +63,7 @@ class FirstAvailableAllocation : public NodeAllocator
     "In most cases, allocating from the available node list will give "
     "you a regular, contiguous allocation")
 
-  FirstAvailableAllocation(SST::Params& params) :
-    NodeAllocator(params)
-  {
-  }
+  FirstAvailableAllocation(SST::Params& params);
 
   std::string toString() const override {
     return "first available allocator";
@@ -79,6 +76,9 @@ class FirstAvailableAllocation : public NodeAllocator
     const ordered_node_set& available,
     ordered_node_set& allocation) const override;
 
+ private:
+  bool contiguous_;
+
 };
 
 
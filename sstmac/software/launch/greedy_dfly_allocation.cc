@@ -107,30 +107,23 @@ class GreedyDflyAllocation :
     int na = dfly->a();
     int conc = dfly->concentration();
     int num_remaining = nnode;
+    int nodes_per_group = na*conc;
     for (int g=0; g < ng; ++g){
       int num_needed = std::min(num_remaining, num_per_group);
-      int num_left = num_needed;
-      std::set<int> nodes_this_group;
-      for (int a=0; a < na; ++a){
-        SwitchId sid = dfly->getUid(a,g);
-        NodeId nid_offset = sid*conc;
-        for (int c=0; c < conc; ++c){
-          NodeId nid = nid_offset + c;
-          //consider this node for addition to the allocation
-          if (available.find(nid) != available.end()){
-            num_left--;
-            nodes_this_group.insert(nid);
-            if (num_left == 0) break;
-          }
-        }
-        if (num_left == 0) break;
+      if (num_needed == 0) break;
+      //the nodes of a group are numbered contiguously
+      NodeId group_start = dfly->getUid(0,g)*conc;
+      NodeId group_end = group_start + nodes_per_group;
+      if (int(available.countRange(group_start, group_end)) < num_needed){
+        continue;
       }
-      if (num_left == 0){
-       //this group has enough to satisfy our request
-       //add the considered nodes to the allocation now
-       num_remaining -= num_needed;
-       for (auto nid : nodes_this_group) allocation.insert(nid);
+      //this group has enough to satisfy our request
+      NodeId nid = available.next(group_start);
+      for (int i=0; i < num_needed; ++i){
+        allocation.insert(nid);
+        nid = available.next(nid + 1);
       }
+      num_remaining -= num_needed;
     }
 
     if (num_remaining > 0){
@@ -166,12 +166,10 @@ JobLauncher::cleanupApp(JobStopRequest* ev)
 
   TaskMapping::ptr themap = TaskMapping::globalMapping(ev->aid());
   TaskMapping::removeGlobalMapping(ev->aid(), ev->uniqueName());
-  const std::vector<NodeId>& rank_to_node = themap->rankToNode();
-  int num_ranks = rank_to_node.size();
+  int num_ranks = themap->numRanks();
   //put all the nodes back in the available map
   for (int i=0; i < num_ranks; ++i){
-    NodeId nid = rank_to_node[i];
-    available_.insert(nid);
+    available_.insert(themap->rankToNode(i));
   }
 }
 
@@ -179,10 +177,9 @@ void
 JobLauncher::satisfyLaunchRequest(AppLaunchRequest* request, const ordered_node_set& allocation)
 {
   TaskMapping::ptr mapping = std::make_shared<TaskMapping>(request->aid());
-  request->indexAllocation(
-     topology_, allocation,
-     mapping->rankToNode(),
-     mapping->nodeToRank());
+  std::vector<NodeId> rank_to_node;
+  request->indexAllocation(topology_, allocation, rank_to_node);
+  mapping->setRankToNode(rank_to_node);
 
   TaskMapping::addGlobalMapping(request->aid(), request->appNamespace(), mapping);
   os_->outcastAppStart(0, request->aid(), request->appNamespace(), mapping, request->appParams(),
@@ -125,8 +125,7 @@ void
 SoftwareLaunchRequest::indexAllocation(
   hw::Topology* top,
   const ordered_node_set& allocation,
-  std::vector<NodeId>& rank_to_node_indexing,
-  std::vector<std::list<int>>& node_to_rank_indexing)
+  std::vector<NodeId>& rank_to_node_indexing)
 {
   indexer_->mapRanks(allocation,
                procs_per_node_,
@@ -154,14 +153,6 @@ SoftwareLaunchRequest::indexAllocation(
 
   }
 
-  int num_nodes = top->numNodes();
-  node_to_rank_indexing.resize(num_nodes);
-  int num_ranks = rank_to_node_indexing.size();
-  for (int i=0; i < num_ranks; ++i){
-    NodeId nid = rank_to_node_indexing[i];
-    node_to_rank_indexing[nid].push_back(i);
-  }
-
   indexed_ = true;
 }
 
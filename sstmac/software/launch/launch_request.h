@@ -108,8 +108,7 @@ class SoftwareLaunchRequest
   void indexAllocation(
     hw::Topology* top,
     const ordered_node_set& allocation,
-    std::vector<NodeId>& rank_to_node,
-    std::vector<std::list<int>>& node_to_rank);
+    std::vector<NodeId>& rank_to_node);
 
   bool isIndexed() const {
     return indexed_;
@@ -45,15 +45,209 @@ Questions? Contact sst-macro-help@sandia.gov
 #ifndef NODE_SET_H
 #define NODE_SET_H
 
-#include <set>
 #include <sstmac/common/node_address.h>
+#include <vector>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
 
 namespace sstmac {
 namespace sw {
 
-typedef std::set<NodeId> ordered_node_set;
+/**
+ * @class ordered_node_set
+ * A set of node ids with the std::set interface the launch code uses.
+ * It is stored as a bitmap with one summary bit per 64-node word.
+ * Finding the next member skips empty stretches of 4096 nodes at a time.
+ * This keeps first-fit, range, and contiguous-block queries cheap when a
+ * job stream repeatedly allocates from a large machine.
+ */
+class ordered_node_set
+{
+ public:
+  static constexpr NodeId npos = NodeId(-1);
+
+  class const_iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef NodeId value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const NodeId* pointer;
+    typedef NodeId reference;
+
+    const_iterator() : set_(nullptr), nid_(npos) {}
+
+    const_iterator(const ordered_node_set* set, NodeId nid) :
+      set_(set), nid_(nid) {}
+
+    NodeId operator*() const {
+      return nid_;
+    }
+
+    const_iterator& operator++(){
+      nid_ = set_->next(nid_ + 1);
+      return *this;
+    }
+
+    const_iterator operator++(int){
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return nid_ == other.nid_;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return nid_ != other.nid_;
+    }
+
+   private:
+    const ordered_node_set* set_;
+    NodeId nid_;
+  };
+
+  typedef const_iterator iterator;
+
+  ordered_node_set() : size_(0) {}
+
+  const_iterator begin() const {
+    return const_iterator(this, next(0));
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, npos);
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear(){
+    words_.clear();
+    summary_.clear();
+    size_ = 0;
+  }
+
+  bool contains(NodeId nid) const {
+    size_t w = nid / 64;
+    return w < words_.size() && (words_[w] >> (nid % 64)) & 1;
+  }
+
+  const_iterator find(NodeId nid) const {
+    return contains(nid) ? const_iterator(this, nid) : end();
+  }
+
+  size_t count(NodeId nid) const {
+    return contains(nid) ? 1 : 0;
+  }
+
+  void insert(NodeId nid){
+    size_t w = nid / 64;
+    if (w >= words_.size()){
+      words_.resize(w + 1, 0);
+      summary_.resize(w / 64 + 1, 0);
+    }
+    uint64_t bit = uint64_t(1) << (nid % 64);
+    if (!(words_[w] & bit)){
+      words_[w] |= bit;
+      summary_[w / 64] |= uint64_t(1) << (w % 64);
+      ++size_;
+    }
+  }
+
+  size_t erase(NodeId nid){
+    if (!contains(nid)) return 0;
+    size_t w = nid / 64;
+    words_[w] &= ~(uint64_t(1) << (nid % 64));
+    if (words_[w] == 0){
+      summary_[w / 64] &= ~(uint64_t(1) << (w % 64));
+    }
+    --size_;
+    return 1;
+  }
+
+  /**
+   * @return The smallest member >= nid, npos if there is none
+   */
+  NodeId next(NodeId nid) const {
+    size_t w = nid / 64;
+    if (nid == npos || w >= words_.size()) return npos;
+    uint64_t bits = words_[w] & (~uint64_t(0) << (nid % 64));
+    if (bits) return w*64 + __builtin_ctzll(bits);
+
+    //use the summary to jump to the next non-empty word
+    size_t sw = (w + 1) / 64;
+    if (sw >= summary_.size()) return npos;
+    uint64_t sbits = (w + 1) % 64 ? summary_[sw] & (~uint64_t(0) << ((w + 1) % 64)) : summary_[sw];
+    while (!sbits){
+      if (++sw == summary_.size()) return npos;
+      sbits = summary_[sw];
+    }
+    w = sw*64 + __builtin_ctzll(sbits);
+    return w*64 + __builtin_ctzll(words_[w]);
+  }
+
+  /**
+   * @return The number of members in [lo,hi)
+   */
+  size_t countRange(NodeId lo, NodeId hi) const {
+    size_t total = 0;
+    while (lo < hi){
+      size_t w = lo / 64;
+      if (w >= words_.size()) break;
+      uint64_t bits = words_[w] & (~uint64_t(0) << (lo % 64));
+      NodeId word_end = (w + 1) * 64;
+      if (hi < word_end){
+        bits &= ~(~uint64_t(0) << (hi % 64));
+      }
+      total += __builtin_popcountll(bits);
+      lo = word_end;
+    }
+    return total;
+  }
+
+  /**
+   * @return The first member of a run of n consecutive members, npos if there is none
+   */
+  NodeId findContiguous(int n) const {
+    NodeId start = next(0);
+    while (start != npos){
+      NodeId nid = start;
+      int run = 1;
+      while (run < n){
+        NodeId nxt = nid + 1;
+        size_t w = nxt / 64;
+        if (nxt % 64 == 0 && (n - run) >= 64 && w < words_.size()
+            && words_[w] == ~uint64_t(0)){
+          //whole word is free, skip over it
+          nid += 64;
+          run += 64;
+        } else if (contains(nxt)){
+          ++nid;
+          ++run;
+        } else {
+          break;
+        }
+      }
+      if (run == n) return start;
+      start = next(nid + 1);
+    }
+    return npos;
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+  std::vector<uint64_t> summary_;
+  size_t size_;
+};
 
 }
 }
 
-#endif // NODE_SET_H
\ No newline at end of file
+#endif // NODE_SET_H
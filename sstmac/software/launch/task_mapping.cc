@@ -1,6 +1,7 @@
 #include <sstmac/software/launch/task_mapping.h>
 #include <sstmac/common/thread_lock.h>
 #include <sprockit/errors.h>
+#include <algorithm>
 
 namespace sstmac {
 namespace sw {
@@ -11,20 +12,109 @@ std::vector<int> TaskMapping::local_refcounts_(1024);
 
 static thread_lock lock;
 
+void
+TaskMapping::setRankToNode(const std::vector<NodeId>& rank_to_node)
+{
+  num_ranks_ = rank_to_node.size();
+  segments_.clear();
+  explicit_.clear();
+  expanded_.clear();
+
+  int rank = 0;
+  while (rank < num_ranks_){
+    Segment seg;
+    seg.first_rank = rank;
+    seg.first_node = rank_to_node[rank];
+    seg.ranks_per_node = 1;
+    while (rank + seg.ranks_per_node < num_ranks_
+           && rank_to_node[rank + seg.ranks_per_node] == seg.first_node){
+      ++seg.ranks_per_node;
+    }
+    int next = rank + seg.ranks_per_node;
+    seg.node_stride = next < num_ranks_ ? int(rank_to_node[next]) - int(seg.first_node) : 1;
+    //extend the segment as long as ranks follow the pattern
+    while (next < num_ranks_){
+      int offset = next - rank;
+      NodeId expected = seg.first_node + (offset / seg.ranks_per_node) * seg.node_stride;
+      if (rank_to_node[next] != expected) break;
+      ++next;
+    }
+    segments_.push_back(seg);
+    rank = next;
+  }
+
+  //irregular maps do not compress, just keep the array
+  int num_segments = segments_.size();
+  if (num_segments > 1 && num_segments * sizeof(Segment) >= num_ranks_ * sizeof(NodeId)){
+    segments_.clear();
+    explicit_ = rank_to_node;
+  }
+}
+
+void
+TaskMapping::nodeToRanks(NodeId node, std::vector<int>& ranks) const
+{
+  ranks.clear();
+  if (!explicit_.empty()){
+    for (int i=0; i < num_ranks_; ++i){
+      if (explicit_[i] == node) ranks.push_back(i);
+    }
+    return;
+  }
+
+  int num_segments = segments_.size();
+  for (int s=0; s < num_segments; ++s){
+    const Segment& seg = segments_[s];
+    int delta = int(node) - int(seg.first_node);
+    int slot;
+    if (seg.node_stride == 0){
+      if (delta != 0) continue;
+      slot = 0;
+    } else {
+      if (delta % seg.node_stride) continue;
+      slot = delta / seg.node_stride;
+      if (slot < 0) continue;
+    }
+    int first = seg.first_rank + slot * seg.ranks_per_node;
+    int last = std::min(first + seg.ranks_per_node, segmentEnd(s));
+    for (int r=first; r < last; ++r){
+      ranks.push_back(r);
+    }
+  }
+}
+
+const std::vector<NodeId>&
+TaskMapping::rankToNode() const
+{
+  if (!explicit_.empty()) return explicit_;
+  lock.lock();
+  if (int(expanded_.size()) != num_ranks_){
+    std::vector<NodeId> expanded(num_ranks_);
+    for (int i=0; i < num_ranks_; ++i){
+      expanded[i] = rankToNode(i);
+    }
+    expanded_.swap(expanded);
+  }
+  lock.unlock();
+  return expanded_;
+}
+
 TaskMapping::ptr
 TaskMapping::serialize_order(AppId aid, serializer &ser)
 {
   TaskMapping::ptr mapping;
   if (ser.mode() == ser.UNPACK){
-    int num_nodes;
-    ser & num_nodes;
     mapping = std::make_shared<TaskMapping>(aid);
-    ser & mapping->rank_to_node_indexing_;
-    mapping->node_to_rank_indexing_.resize(num_nodes);
-    int num_ranks = mapping->rank_to_node_indexing_.size();
-    for (int i=0; i < num_ranks; ++i){
-      NodeId nid = mapping->rank_to_node_indexing_[i];
-      mapping->node_to_rank_indexing_[nid].push_back(i);
+    ser & mapping->num_ranks_;
+    ser & mapping->explicit_;
+    int num_segments;
+    ser & num_segments;
+    mapping->segments_.resize(num_segments);
+    for (Segment& seg : mapping->segments_){
+      ser & seg.first_rank;
+      ser & seg.ranks_per_node;
+      ser & seg.first_node;
+      ser & seg.node_stride;
     }
     lock.lock();
     auto existing = app_ids_launched_[aid];
@@ -38,9 +128,16 @@ TaskMapping::serialize_order(AppId aid, serializer &ser)
     //packing or sizing
     mapping = app_ids_launched_[aid];
     if (!mapping) spkt_abort_printf("no task mapping exists for application %d", aid);
-    int num_nodes = mapping->node_to_rank_indexing_.size();
-    ser & num_nodes;
-    ser & mapping->rank_to_node_indexing_;
+    ser & mapping->num_ranks_;
+    ser & mapping->explicit_;
+    int num_segments = mapping->segments_.size();
+    ser & num_segments;
+    for (Segment& seg : mapping->segments_){
+      ser & seg.first_rank;
+      ser & seg.ranks_per_node;
+      ser & seg.first_node;
+      ser & seg.node_stride;
+    }
   }
   return mapping;
 }
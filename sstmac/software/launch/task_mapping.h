@@ -1,7 +1,6 @@
 #ifndef sstmac_sw_launch_task_mapping_h
 #define sstmac_sw_launch_task_mapping_h
 
-#include <list>
 #include <vector>
 #include <map>
 #include <memory>
@@ -12,19 +11,32 @@
 namespace sstmac {
 namespace sw {
 
+/**
+ * The rank-to-node map of an application. Block, cyclic and strided
+ * mappings are stored as a few run-length segments, each of which places
+ * consecutive ranks ranksPerNode at a time on nodes a fixed stride apart.
+ * Irregular mappings fall back to an explicit array.
+ */
 class TaskMapping {
  public:
-  TaskMapping(AppId aid) : aid_(aid) {}
+  TaskMapping(AppId aid) : aid_(aid), num_ranks_(0) {}
 
   typedef std::shared_ptr<TaskMapping> ptr;
 
   NodeId rankToNode(int rank) const {
-    return rank_to_node_indexing_[rank];
+    if (!explicit_.empty()){
+      return explicit_[rank];
+    }
+    const Segment& seg = segment(rank);
+    return seg.first_node + ((rank - seg.first_rank) / seg.ranks_per_node) * seg.node_stride;
   }
 
-  const std::list<int>& nodeToRanks(int node) const {
-    return node_to_rank_indexing_[node];
-  }
+  /**
+   * @brief nodeToRanks Answered from the segments without expanding the map
+   * @param node
+   * @param ranks [OUT] The ranks placed on the node, in increasing order
+   */
+  void nodeToRanks(NodeId node, std::vector<int>& ranks) const;
 
   AppId aid() const {
     return aid_;
@@ -33,28 +45,31 @@ class TaskMapping {
   static TaskMapping::ptr serialize_order(AppId aid, serializer& ser);
 
   int numRanks() const {
-    return rank_to_node_indexing_.size();
+    return num_ranks_;
   }
 
   int nproc() const {
-    return rank_to_node_indexing_.size();
-  }
-
-  const std::vector<NodeId>& rankToNode() const {
-    return rank_to_node_indexing_;
-  }
-
-  std::vector<NodeId>& rankToNode() {
-    return rank_to_node_indexing_;
+    return num_ranks_;
   }
 
-  const std::vector<std::list<int>>& nodeToRank() const {
-    return node_to_rank_indexing_;
+  /**
+   * @brief setRankToNode Encode a rank-to-node map, compressing it if possible
+   * @param rank_to_node
+   */
+  void setRankToNode(const std::vector<NodeId>& rank_to_node);
+
+  /**
+   * @return Whether the map is stored as an explicit array
+   */
+  bool isExplicit() const {
+    return !explicit_.empty();
   }
 
-  std::vector<std::list<int>>& nodeToRank() {
-    return node_to_rank_indexing_;
-  }
+  /**
+   * @brief rankToNode Expand the full map. This is only built on request
+   *        for code that needs a flat array.
+   */
+  const std::vector<NodeId>& rankToNode() const;
 
   static const TaskMapping::ptr& globalMapping(AppId aid);
 
@@ -66,9 +81,34 @@ class TaskMapping {
   static void removeGlobalMapping(AppId aid, const std::string& name);
 
  private:
+  struct Segment {
+    int first_rank;
+    int ranks_per_node;
+    NodeId first_node;
+    int node_stride;
+  };
+
+  const Segment& segment(int rank) const {
+    if (segments_.size() == 1) return segments_[0];
+    //find the last segment starting at or before the rank
+    int lo = 0, hi = segments_.size() - 1;
+    while (lo < hi){
+      int mid = (lo + hi + 1) / 2;
+      if (segments_[mid].first_rank <= rank) lo = mid;
+      else hi = mid - 1;
+    }
+    return segments_[lo];
+  }
+
+  int segmentEnd(int idx) const {
+    return idx + 1 < int(segments_.size()) ? segments_[idx+1].first_rank : num_ranks_;
+  }
+
   AppId aid_;
-  std::vector<NodeId> rank_to_node_indexing_;
-  std::vector<std::list<int> > node_to_rank_indexing_;
+  int num_ranks_;
+  std::vector<Segment> segments_;
+  std::vector<NodeId> explicit_;
+  mutable std::vector<NodeId> expanded_;
   std::vector<int> core_affinities_;
 
   static std::vector<int>  local_refcounts_;
@@ -115,6 +115,13 @@ extern "C" void sstmac_compute_detailed_nthr(uint64_t nflops, uint64_t nintops,
     ->computeDetailed(nflops, nintops, bytes, nthread);
 }
 
+extern "C" void sstmac_omp_parallel_for(uint64_t niter, int schedule, uint64_t chunk,
+                                        uint64_t nflops, uint64_t nintops, uint64_t bytes,
+                                        int nthread){
+  sstmac::sw::OperatingSystem::currentThread()
+    ->computeParallelFor(niter, schedule, chunk, nflops, nintops, bytes, nthread);
+}
+
 extern "C" void sstmac_computeLoop(uint64_t num_loops, uint32_t nflops_per_loop,
                     uint32_t nintops_per_loop, uint32_t bytes_per_loop){
   sstmac::sw::OperatingSystem::currentThread()->parentApp()
@@ -90,6 +90,27 @@ void sstmac_computeDetailed(uint64_t nflops, uint64_t nintops, uint64_t bytes);
 void sstmac_compute_detailed_nthr(uint64_t nflops, uint64_t nintops, uint64_t bytes,
                                   int nthread);
 
+/* Schedule kinds, numbered as in omp_sched_t */
+#define SSTMAC_OMP_SCHED_STATIC 1
+#define SSTMAC_OMP_SCHED_DYNAMIC 2
+#define SSTMAC_OMP_SCHED_GUIDED 3
+#define SSTMAC_OMP_SCHED_AUTO 4
+
+/**
+ * @brief sstmac_omp_parallel_for Model an OpenMP parallel for analytically,
+ *        as a single compute event rather than a team of threads
+ * @param niter    The number of iterations of the parallel loop
+ * @param schedule One of the SSTMAC_OMP_SCHED kinds
+ * @param chunk    The chunk size from the schedule clause, 0 if none given
+ * @param nflops   The total flops across all iterations
+ * @param nintops  The total int ops across all iterations
+ * @param bytes    The total bytes across all iterations
+ * @param nthread  The team size, or -1 to use omp_get_max_threads
+ */
+void sstmac_omp_parallel_for(uint64_t niter, int schedule, uint64_t chunk,
+                             uint64_t nflops, uint64_t nintops, uint64_t bytes,
+                             int nthread);
+
 /**
  * @brief sstmac_compute_loop
  * @param num_loops        The number of loops to execute
@@ -133,6 +133,10 @@ struct basic_instructions_st
   uint64_t flops = 0ULL;
   uint64_t intops = 0ULL;
   int nthread = 1;
+  /** Ratio of the busiest thread's work to an even split across nthread */
+  double imbalance = 1.0;
+  /** Fixed time added to the instruction time, e.g. parallel region fork/join */
+  Timestamp overhead;
 };
 
 typedef ComputeEvent_impl<Timestamp> TimedComputeEvent;
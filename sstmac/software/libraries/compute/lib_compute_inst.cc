@@ -52,6 +52,11 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
 #include <sstmac/software/process/ftq.h>
+#include <sstmac/software/libraries/compute/compute_api.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
 
 RegisterDebugSlot(lib_compute_inst);
 
@@ -61,7 +66,9 @@ namespace sw {
 RegisterKeywords(
  { "lib_compute_unroll_loops", "DEPRECATED: tunes the loop control overhead for compute loop functions" },
  { "lib_compute_loop_overhead", "the number of instructions in control overhead per compute loop" },
- { "lib_compute_access_width", "the size of each memory access access in bits" }
+ { "lib_compute_access_width", "the size of each memory access access in bits" },
+ { "omp_fork_join_overhead", "the fixed cost of entering and leaving an analytic OpenMP parallel region" },
+ { "omp_chunk_overhead", "the cost of dispatching each chunk of a dynamic or guided OpenMP loop" }
 );
 
 LibComputeInst::LibComputeInst(SST::Params& params,
@@ -118,6 +125,95 @@ LibComputeInst::computeLoop(uint64_t num_loops,
     bytes_per_loop*num_loops);
 }
 
+void
+LibComputeInst::ompMakespan(uint64_t niter, int schedule, uint64_t chunk, int nworkers,
+                            uint64_t& busiest_iters, uint64_t& busiest_chunks)
+{
+  if (schedule == SSTMAC_OMP_SCHED_GUIDED){
+    //chunks shrink as the loop drains, each going to whichever thread frees up first
+    //iterations cost the same, so the first free thread is the one with the fewest
+    typedef std::pair<uint64_t,uint64_t> load; //iterations, chunks
+    std::priority_queue<load, std::vector<load>, std::greater<load>> threads;
+    for (int i=0; i < nworkers; ++i) threads.emplace(0,0);
+    uint64_t min_chunk = std::max(chunk, uint64_t(1));
+    uint64_t remaining = niter;
+    while (remaining){
+      uint64_t size = std::max((remaining + nworkers - 1) / nworkers, min_chunk);
+      size = std::min(size, remaining);
+      load next = threads.top(); threads.pop();
+      threads.emplace(next.first + size, next.second + 1);
+      remaining -= size;
+    }
+    busiest_iters = busiest_chunks = 0;
+    while (!threads.empty()){
+      busiest_iters = std::max(busiest_iters, threads.top().first);
+      busiest_chunks = std::max(busiest_chunks, threads.top().second);
+      threads.pop();
+    }
+    return;
+  }
+
+  if (chunk == 0){
+    if (schedule == SSTMAC_OMP_SCHED_DYNAMIC){
+      chunk = 1;
+    } else {
+      //one contiguous block per thread
+      busiest_iters = (niter + nworkers - 1) / nworkers;
+      busiest_chunks = 1;
+      return;
+    }
+  }
+
+  //fixed-size chunks dealt round-robin - with uniform iterations
+  //dynamic scheduling hands them out in the same order
+  uint64_t nchunks = (niter + chunk - 1) / chunk;
+  uint64_t full = nchunks / nworkers;
+  uint64_t rem = nchunks % nworkers;
+  uint64_t last = niter - (nchunks - 1)*chunk;
+  busiest_chunks = rem ? full + 1 : full;
+  if (nworkers == 1){
+    busiest_iters = niter;
+  } else if (rem == 1){
+    //thread 0 has the most chunks, but also the short last one
+    busiest_iters = full*chunk + last;
+  } else {
+    busiest_iters = busiest_chunks*chunk;
+  }
+}
+
+void
+LibComputeInst::computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+  uint64_t flops, uint64_t nintops, uint64_t bytes, int nthread)
+{
+  if (niter == 0) return;
+
+  //threads beyond the cores we can get without waiting would just time-share,
+  //and blocking for cores held by other ranks could wait forever
+  int ncores = os_->activeThread()->numActiveCcores() + os_->nfreeCores();
+  int nworkers = std::max(std::min(nthread, ncores), 1);
+  uint64_t busiest_iters, busiest_chunks;
+  ompMakespan(niter, schedule, chunk, nworkers, busiest_iters, busiest_chunks);
+
+  auto cmsg = new ComputeEvent_impl<basic_instructions_st>;
+  basic_instructions_st& st = cmsg->data();
+  st.flops = flops;
+  st.intops = nintops;
+  st.mem_sequential = bytes;
+  st.nthread = nworkers;
+  st.imbalance = double(busiest_iters) * nworkers / niter;
+  st.overhead = omp_fork_join_overhead_;
+  if (schedule == SSTMAC_OMP_SCHED_DYNAMIC || schedule == SSTMAC_OMP_SCHED_GUIDED){
+    st.overhead += omp_chunk_overhead_ * double(busiest_chunks);
+  }
+
+  const auto& cur_tag = os_->activeThread()->tag();
+  FTQScope scope(os_->activeThread(),
+      cur_tag.id() == FTQTag::null.id() ? FTQTag::compute : cur_tag);
+
+  computeInst(cmsg, nworkers);
+  delete cmsg;
+}
+
 void
 LibComputeInst::init(SST::Params& params)
 {
@@ -127,6 +223,10 @@ LibComputeInst::init(SST::Params& params)
   } else {
     loop_overhead_ = params.find<double>("lib_compute_loop_overhead", 1.0);
   }
+  omp_fork_join_overhead_ = Timestamp(
+    params.find<SST::UnitAlgebra>("omp_fork_join_overhead", "1us").getValue().toDouble());
+  omp_chunk_overhead_ = Timestamp(
+    params.find<SST::UnitAlgebra>("omp_chunk_overhead", "100ns").getValue().toDouble());
 }
 
 void
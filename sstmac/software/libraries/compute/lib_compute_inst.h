@@ -82,6 +82,20 @@ class LibComputeInst :
     uint32_t intops_per_loop,
     uint32_t bytes_per_loop);
 
+  /**
+   * Model an OpenMP parallel for as a single compute event. The region
+   * takes as long as its busiest thread, given how the schedule deals
+   * out iterations across nthread workers, or fewer if fewer cores are free.
+   * @param niter     The number of iterations in the parallel loop
+   * @param schedule  One of the SSTMAC_OMP_SCHED kinds
+   * @param chunk     The chunk size, 0 for the schedule's default
+   * @param flops     The total flops across all iterations
+   * @param nintops   The total int ops across all iterations
+   * @param bytes     The total bytes across all iterations
+   */
+  void computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+    uint64_t flops, uint64_t nintops, uint64_t bytes, int nthread);
+
   virtual void incomingEvent(Event *ev) override {
     Library::incomingEvent(ev);
   }
@@ -89,9 +103,16 @@ class LibComputeInst :
  protected:
   double loop_overhead_;
 
+  Timestamp omp_fork_join_overhead_;
+
+  Timestamp omp_chunk_overhead_;
+
  private:
   void init(SST::Params& params);
 
+  static void ompMakespan(uint64_t niter, int schedule, uint64_t chunk, int nworkers,
+                          uint64_t& busiest_iters, uint64_t& busiest_chunks);
+
 };
 
 }
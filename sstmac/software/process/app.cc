@@ -74,9 +74,11 @@ static sprockit::NeedDeletestatics<sstmac::sw::UserAppCxxFullMain> del_app_stati
 
 RegisterKeywords(
  { "host_compute_timer", "whether to use the time elapsed on the host machine in compute modeling" },
+ { "host_compute_batch", "accumulate host-timed compute until this much is pending before advancing simulated time" },
  { "min_op_cutoff", "the minimum number of operations in a compute before detailed modeling is perfromed" },
  { "notify", "whether the app should send completion notifications to job root" },
  { "globals_size", "the size of the global variable segment to allocate" },
+ { "globals_copy_on_write", "whether to share untouched pages of global variable segments across ranks" },
  { "OMP_NUM_THREADS", "environment variable for configuring openmp" },
  { "exe", "an optional exe .so file to load for this app" },
 );
@@ -106,22 +108,16 @@ App::allocateTlsKey(destructor_fxn fxn)
 }
 
 static char* get_data_segment(SST::Params& params,
-                              const char* param_name, GlobalVariableContext& ctx)
+                              const char* param_name, GlobalVariableContext& ctx,
+                              bool copy_on_write)
 {
-  int allocSize = ctx.allocSize();
   if (params.contains(param_name)){
-    allocSize = params.find<int>(param_name);
+    int allocSize = params.find<int>(param_name);
     if (ctx.allocSize() != allocSize){
       ctx.setAllocSize(allocSize);
     }
   }
-  if (allocSize != 0){
-    char* segment = new char[allocSize];
-    ::memcpy(segment, ctx.globalInit(), ctx.globalsSize());
-    return segment;
-  } else {
-    return nullptr;
-  }
+  return ctx.allocateSegment(copy_on_write);
 }
 
 
@@ -184,9 +180,9 @@ char*
 App::allocateDataSegment(bool tls)
 {
   if (tls){
-    return get_data_segment(params_, "tls_size", GlobalVariable::tlsCtx);
+    return get_data_segment(params_, "tls_size", GlobalVariable::tlsCtx, cow_segments_);
   } else {
-    return get_data_segment(params_, "globals_size", GlobalVariable::glblCtx);
+    return get_data_segment(params_, "globals_size", GlobalVariable::glblCtx, cow_segments_);
   }
 }
 
@@ -196,18 +192,23 @@ App::App(SST::Params& params, SoftwareId sid,
   compute_lib_(nullptr),
   params_(params),
   next_tls_key_(0),
-  next_condition_(0),
   notify_(true),
-  next_mutex_(0),
   min_op_cutoff_(0),
   globals_storage_(nullptr),
   rc_(0)
 {
+  cow_segments_ = params.find<bool>("globals_copy_on_write", false);
   globals_storage_ = allocateDataSegment(false); //not tls
+  if (params.contains("tls_size")){
+    //size TLS before any is allocated so the OS knows whether pooled TLS fits
+    GlobalVariable::tlsCtx.setAllocSize(params.find<int>("tls_size"));
+  }
   min_op_cutoff_ = params.find<long>("min_op_cutoff", 1000);
   bool host_compute = params.find<bool>("host_compute_timer", false);
   if (host_compute){
     host_timer_ = new HostTimer;
+    host_compute_batch_ = Timestamp(
+      params.find<SST::UnitAlgebra>("host_compute_batch", "0s").getValue().toDouble());
   }
 
   notify_ = params.find<bool>("notify", true);
@@ -269,7 +270,7 @@ App::~App()
   /** These get deleted by unregister */
   //sprockit::delete_vals(apis_);
   if (compute_lib_) delete compute_lib_;
-  if (globals_storage_) delete[] globals_storage_;
+  GlobalVariable::glblCtx.freeSegment(globals_storage_, aid());
 }
 
 int
@@ -387,6 +388,22 @@ App::computeDetailed(uint64_t flops, uint64_t nintops, uint64_t bytes, int nthre
   computeLib()->computeDetailed(flops, nintops, bytes, nthread);
 }
 
+void
+App::computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+                        uint64_t flops, uint64_t nintops, uint64_t bytes, int nthread)
+{
+  if ((flops+nintops) < min_op_cutoff_){
+    return;
+  }
+
+  debug_printf(sprockit::dbg::app_compute,
+               "Rank %d for app %d: parallel for niter=%" PRIu64 " schedule=%d chunk=%" PRIu64
+               " nthread=%d flops=%" PRIu64 " intops=%" PRIu64 " bytes=%" PRIu64,
+               sid_.task_, sid_.app_, niter, schedule, chunk, nthread, flops, nintops, bytes);
+
+  computeLib()->computeParallelFor(niter, schedule, chunk, flops, nintops, bytes, nthread);
+}
+
 void
 App::computeBlockRead(uint64_t bytes)
 {
@@ -488,65 +505,78 @@ App::removeSubthread(Thread *thr)
   subthreads_.erase(thr->threadId());
 }
 
-bool
-App::eraseMutex(int id)
+template <class T>
+int
+App::allocateHandle(HandleTable<T>& table)
 {
-  std::map<int,mutex_t>::iterator it = mutexes_.find(id);
-  if (it == mutexes_.end()){
-    return false;
+  int id;
+  if (table.free_ids.empty()){
+    id = table.slots.size();
+    table.slots.emplace_back();
   } else {
-    mutexes_.erase(id);
-    return true;
+    id = table.free_ids.back();
+    table.free_ids.pop_back();
   }
+  table.slots[id].reset(new T);
+  return id;
 }
 
+template <class T>
 bool
-App::eraseCondition(int id)
+App::eraseHandle(HandleTable<T>& table, int id)
 {
-  std::map<int,condition_t>::iterator it = conditions_.find(id);
-  if (it == conditions_.end()){
-    return false;
-  } else {
-    conditions_.erase(id);
-    return true;
-  }
+  if (!handle(table, id)) return false;
+  table.slots[id].reset();
+  table.free_ids.push_back(id);
+  return true;
 }
 
-mutex_t*
-App::getMutex(int id)
+bool
+App::eraseMutex(int id)
 {
-  std::map<int,mutex_t>::iterator it = mutexes_.find(id);
-  if (it==mutexes_.end()){
-    return 0;
-  } else {
-    return &it->second;
-  }
+  return eraseHandle(mutexes_, id);
+}
+
+bool
+App::eraseCondition(int id)
+{
+  return eraseHandle(conditions_, id);
 }
 
 int
 App::allocateMutex()
 {
-  int id = next_mutex_++;
-  mutexes_[id]; //implicit make
-  return id;
+  return allocateHandle(mutexes_);
 }
 
 int
 App::allocateCondition()
 {
-  int id = next_condition_++;
-  conditions_[id]; //implicit make
-  return id;
+  return allocateHandle(conditions_);
 }
 
-condition_t*
-App::getCondition(int id)
+void
+mutex_t::lock(Thread* thr)
+{
+  if (locked){
+    waiters.push_back(thr);
+    //unlock hands ownership over before waking us
+    thr->os()->block();
+  } else {
+    locked = true;
+  }
+}
+
+void
+mutex_t::unlock(Thread* thr)
 {
-  std::map<int,condition_t>::iterator it = conditions_.find(id);
-  if (it==conditions_.end()){
-    return 0;
+  if (waiters.empty()){
+    locked = false;
   } else {
-    return &it->second;
+    //direct hand-off: stays locked, now owned by the next waiter
+    Thread* next = waiters.front();
+    waiters.pop_front();
+    thr->os()->unblock(next);
   }
 }
 
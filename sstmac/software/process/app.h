@@ -56,6 +56,10 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/factory.h>
 #include <sprockit/sim_parameters.h>
 
+#include <list>
+#include <memory>
+#include <vector>
+
 #ifdef sleep
 #if sleep == sstmac_sleep
 #define refactor_sleep_macro
@@ -70,15 +74,37 @@ class mutex_t  {
  public:
   /** Blocking keys for those threads waiting on the mutex */
   std::list<Thread*> waiters;
-  std::list<Thread*> conditionals;
   bool locked;
 
   mutex_t() : locked(false)
   {
   }
+
+  /**
+   * Acquire the mutex. An uncontended lock never touches the event queue.
+   * A contended lock blocks and wakes already owning the mutex.
+   */
+  void lock(Thread* thr);
+
+  /** @return Whether the mutex was acquired */
+  bool tryLock(){
+    if (locked) return false;
+    locked = true;
+    return true;
+  }
+
+  /**
+   * Release the mutex, handing ownership directly to the first waiter
+   * so the woken thread never has to contend for it again.
+   */
+  void unlock(Thread* thr);
 };
 
-typedef std::map<long, mutex_t*> condition_t;
+class condition_t {
+ public:
+  /** Waiting threads and the mutex each must reacquire on wakeup */
+  std::list<std::pair<Thread*,mutex_t*>> waiters;
+};
 
 /**
  * The app derived class adds to the thread base class by providing
@@ -194,14 +220,18 @@ class App : public Thread
    * @param id
    * @return The mutex object corresponding to the ID. Return NULL if no mutex is found.
    */
-  mutex_t* getMutex(int id);
+  mutex_t* getMutex(int id){
+    return handle(mutexes_, id);
+  }
 
   /**
    * Fetch a condition object corresponding to the ID
    * @param id
    * @return The condition object corresponding to the ID. Return NULL if not condition is found.
    */
-  condition_t* getCondition(int id);
+  condition_t* getCondition(int id){
+    return handle(conditions_, id);
+  }
 
   bool eraseCondition(int id);
 
@@ -215,6 +245,10 @@ class App : public Thread
     return allocateDataSegment(true);
   }
 
+  bool cowSegments() const {
+    return cow_segments_;
+  }
+
   const std::string& uniqueName() const {
     return unique_name_;
   }
@@ -246,17 +280,40 @@ class App : public Thread
 
   void computeDetailed(uint64_t flops, uint64_t intops, uint64_t bytes, int nthread);
 
+  void computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+                          uint64_t flops, uint64_t intops, uint64_t bytes, int nthread);
+
   LibComputeMemmove* compute_lib_;
   std::string unique_name_;
 
   int next_tls_key_;
-  int next_condition_;
-  int next_mutex_;
   uint64_t min_op_cutoff_;
 
+  /**
+   * Dense id -> object table, so the lookup on every lock/wait is
+   * a bounds check and an index. Erased ids are recycled.
+   */
+  template <class T>
+  struct HandleTable {
+    std::vector<std::unique_ptr<T>> slots;
+    std::vector<int> free_ids;
+  };
+
+  template <class T>
+  static T* handle(HandleTable<T>& table, int id){
+    if (id < 0 || id >= int(table.slots.size())) return nullptr;
+    return table.slots[id].get();
+  }
+
+  template <class T>
+  static int allocateHandle(HandleTable<T>& table);
+
+  template <class T>
+  static bool eraseHandle(HandleTable<T>& table, int id);
+
   std::map<long, Thread*> subthreads_;
-  std::map<int, mutex_t> mutexes_;
-  std::map<int, condition_t> conditions_;
+  HandleTable<mutex_t> mutexes_;
+  HandleTable<condition_t> conditions_;
   std::map<int, destructor_fxn> tls_key_fxns_;
   //these can alias - so I can't use unique_ptr
   std::map<std::string, API*> apis_;
@@ -266,6 +323,9 @@ class App : public Thread
 
   char* globals_storage_;
 
+  /** Whether global and TLS segments are copy-on-write mappings of the initial values */
+  bool cow_segments_;
+
   bool notify_;
 
   int rc_;
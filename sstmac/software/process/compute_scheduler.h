@@ -90,6 +90,12 @@ class ComputeScheduler
   
   virtual void releaseCores(int ncore, Thread* thr) = 0;
 
+  /**
+   * @param thr The physical thread that would reserve them
+   * @return How many more cores thr could reserve right now without blocking
+   */
+  virtual int nfreeCores(Thread* thr) const = 0;
+
 
  protected:
   int ncores_;
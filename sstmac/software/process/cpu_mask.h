@@ -0,0 +1,152 @@
+#ifndef sstmac_software_process_cpu_mask_h
+#define sstmac_software_process_cpu_mask_h
+
+#include <sstmac/libraries/pthread/sstmac_cpu_set.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Fixed-width set of cores, laid out like sstmac_cpu_set_t so affinity
+ * masks pass between the pthread/sched replacements and the OS unchanged.
+ * Wide enough for many-core node models - lookups scan words, not cores.
+ */
+class CpuMask
+{
+ public:
+  static const int max_cores = SSTMAC_CPU_SETSIZE;
+  static const int nwords = SSTMAC_CPU_SETWORDS;
+
+  CpuMask(){
+    ::memset(words_, 0, sizeof(words_));
+  }
+
+  CpuMask(const sstmac_cpu_set_t& set){
+    ::memcpy(words_, set.cpubits, sizeof(words_));
+  }
+
+  static CpuMask all(){
+    CpuMask m;
+    ::memset(m.words_, 0xFF, sizeof(m.words_));
+    return m;
+  }
+
+  /**
+   * @return A mask with cores [0,ncores) set
+   */
+  static CpuMask firstN(int ncores){
+    CpuMask m;
+    for (int i=0; i < ncores; ++i) m.set(i);
+    return m;
+  }
+
+  void toCpuSet(sstmac_cpu_set_t* set) const {
+    ::memcpy(set->cpubits, words_, sizeof(words_));
+  }
+
+  void set(int core){
+    words_[core/64] |= bit(core);
+  }
+
+  void clear(int core){
+    words_[core/64] &= ~bit(core);
+  }
+
+  bool test(int core) const {
+    return words_[core/64] & bit(core);
+  }
+
+  bool any() const {
+    for (int w=0; w < nwords; ++w){
+      if (words_[w]) return true;
+    }
+    return false;
+  }
+
+  int count() const {
+    int n = 0;
+    for (int w=0; w < nwords; ++w) n += __builtin_popcountll(words_[w]);
+    return n;
+  }
+
+  /**
+   * @return The lowest set core at or above start, -1 if none
+   */
+  int findFirst(int start = 0) const {
+    if (start >= max_cores) return -1;
+    int w = start / 64;
+    uint64_t word = words_[w] & (~uint64_t(0) << (start % 64));
+    while (true){
+      if (word) return w*64 + __builtin_ctzll(word);
+      if (++w == nwords) return -1;
+      word = words_[w];
+    }
+  }
+
+  /**
+   * @return Whether every core in this mask is also in other
+   */
+  bool subsetOf(const CpuMask& other) const {
+    for (int w=0; w < nwords; ++w){
+      if (words_[w] & ~other.words_[w]) return false;
+    }
+    return true;
+  }
+
+  uint64_t word(int w) const {
+    return words_[w];
+  }
+
+  CpuMask operator&(const CpuMask& other) const {
+    CpuMask m;
+    for (int w=0; w < nwords; ++w) m.words_[w] = words_[w] & other.words_[w];
+    return m;
+  }
+
+  CpuMask& operator|=(const CpuMask& other){
+    for (int w=0; w < nwords; ++w) words_[w] |= other.words_[w];
+    return *this;
+  }
+
+  CpuMask& operator&=(const CpuMask& other){
+    for (int w=0; w < nwords; ++w) words_[w] &= other.words_[w];
+    return *this;
+  }
+
+  /** Remove all cores in other from this mask */
+  CpuMask& subtract(const CpuMask& other){
+    for (int w=0; w < nwords; ++w) words_[w] &= ~other.words_[w];
+    return *this;
+  }
+
+  bool operator==(const CpuMask& other) const {
+    return ::memcmp(words_, other.words_, sizeof(words_)) == 0;
+  }
+
+  bool operator!=(const CpuMask& other) const {
+    return !(*this == other);
+  }
+
+  struct Hash {
+    std::size_t operator()(const CpuMask& m) const {
+      uint64_t h = 0;
+      for (int w=0; w < nwords; ++w) h = h*0x9E3779B97F4A7C15ULL + m.words_[w];
+      return h;
+    }
+  };
+
+ private:
+  static uint64_t bit(int core){
+    return uint64_t(1) << (core % 64);
+  }
+
+  uint64_t words_[nwords];
+};
+
+}
+}
+
+#endif
@@ -53,15 +53,14 @@ bool
 CpusetComputeScheduler::allocateCores(int ncores_needed, Thread* thr)
 {
   int ncores_found = 0;
-  uint64_t valid_cores = thr->cpumask() & available_cores_;
+  CpuMask valid_cores = thr->cpumask() & available_cores_;
   for (int i=0; i < ncores_ && ncores_found < ncores_needed; ++i){
-    uint64_t mask = valid_cores & (1<<i);
-    if (mask != 0){
+    if (valid_cores.test(i)){
       ++ncores_found;
       thr->addActiveCore(i);
       debug_printf(sprockit::dbg::compute_scheduler,
           "Core %d matches from available set %X intersecting thread cpumask %X for thread %ld",
-          i, available_cores_, thr->cpumask(), thr->threadId());
+          i, printable(available_cores_), printable(thr->cpumask()), thr->threadId());
     }
   }
 
@@ -71,11 +70,10 @@ CpusetComputeScheduler::allocateCores(int ncores_needed, Thread* thr)
     }
     return false;
   } else {
-    uint64_t mask = thr->activeCoreMask();
-    available_cores_ = available_cores_ & ~mask;
+    available_cores_.subtract(thr->activeCoreMask());
     debug_printf(sprockit::dbg::compute_scheduler,
         "Available mask is %X after subtracting %X",
-        available_cores_, thr->activeCoreMask());
+        printable(available_cores_), printable(thr->activeCoreMask()));
     return true;
   }
 }
@@ -90,12 +88,18 @@ CpusetComputeScheduler::reserveCores(int ncores, Thread *thr)
     //this is guaranteed not to unblock until valid core received
     debug_printf(sprockit::dbg::compute_scheduler,
         "Failed to find %d cores for thread %u matching cpuset %X against available %X",
-        ncores, thr->threadId(), thr->cpumask(), available_cores_);
+        ncores, thr->threadId(), printable(thr->cpumask()), printable(available_cores_));
     pending_threads_.emplace_back(ncores, thr);
     os_->block();
   }
 }
 
+int
+CpusetComputeScheduler::nfreeCores(Thread *thr) const
+{
+  return (available_cores_ & thr->cpumask()).count();
+}
+
 void
 CpusetComputeScheduler::releaseCores(int ncores, Thread *thr)
 {  
@@ -104,7 +108,7 @@ CpusetComputeScheduler::releaseCores(int ncores, Thread *thr)
     Thread::addCore(core, available_cores_);
     debug_printf(sprockit::dbg::compute_scheduler,
         "Releasing core %d for thread %u yields cpuset %X",
-        core, thr->threadId(), available_cores_);
+        core, thr->threadId(), printable(available_cores_));
   }
 
 
@@ -120,7 +124,8 @@ CpusetComputeScheduler::releaseCores(int ncores, Thread *thr)
     } else {
       debug_printf(sprockit::dbg::compute_scheduler,
           "Failed to find %d cores for thread %u matching cpuset %X against available %X",
-          ncores, pair.second->threadId(), pair.second->cpumask(), available_cores_);
+          ncores, pair.second->threadId(), printable(pair.second->cpumask()),
+          printable(available_cores_));
     }
   }
 }
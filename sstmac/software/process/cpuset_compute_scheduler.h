@@ -46,6 +46,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #define CPUSET_COMPUTE_scheduleR_H
 
 #include <sstmac/software/process/compute_scheduler.h>
+#include <sstmac/software/process/cpu_mask.h>
+#include <list>
 
 namespace sstmac {
 namespace sw {
@@ -63,26 +65,25 @@ class CpusetComputeScheduler : public ComputeScheduler
 
   CpusetComputeScheduler(SST::Params& params,
                            OperatingSystem* os, int ncore, int nsockets) :
-    available_cores_(0),
+    available_cores_(CpuMask::firstN(ncore)),
     ComputeScheduler(params, os, ncore, nsockets)
   {
-    //all cores greater than ncore should be removed from bitmask
-    for (int i=0; i < ncore; ++i){
-      available_cores_ = available_cores_ | (1<<i);
-    }
   }
   
   void reserveCores(int ncore, Thread *thr) override;
   
   void releaseCores(int ncore, Thread *thr) override;
+
+  int nfreeCores(Thread *thr) const override;
   
  private:  
-  inline uint64_t allocatedCores() const {
-    return ~available_cores_;
+  //low word only, for debug output
+  static unsigned printable(const CpuMask& mask){
+    return mask.word(0);
   }
 
  private:
-  uint64_t available_cores_;
+  CpuMask available_cores_;
   std::list<std::pair<int,Thread*>> pending_threads_;
 
 
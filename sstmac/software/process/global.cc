@@ -46,6 +46,20 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
 #include <sstmac/software/process/cppglobal.h>
+#include <sstmac/common/thread_lock.h>
+#include <sprockit/errors.h>
+#include <sprockit/util.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+#include <ostream>
 
 extern "C" {
 
@@ -131,6 +145,8 @@ GlobalVariableContext::append(const int size, const char* name, const void *init
   //       name, size, offset, (realloc ? "reallocated to fit" : "already fits"));
   //fflush(stdout);
 
+  imageSynced_ = false;
+
   if (initData){
     void* initStart = (char*)globalInits + stackOffset;
     ::memcpy(initStart, initData, size);
@@ -226,6 +242,10 @@ GlobalVariableContext::~GlobalVariableContext()
     delete[] globalInits;
     globalInits = nullptr;
   }
+  if (imageFd_ >= 0){
+    ::close(imageFd_);
+    imageFd_ = -1;
+  }
 }
 
 void
@@ -239,6 +259,152 @@ GlobalVariableContext::initGlobalSpace(void* ptr, int size, int offset)
   //also do the global init for any new threads spawned
   char* dst = ((char*)globalInits) + offset;
   ::memcpy(dst, ptr, size);
+  imageSynced_ = false;
+}
+
+static thread_lock segment_lock;
+
+static size_t page_size()
+{
+  static size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+static int create_image_file()
+{
+  int fd = -1;
+#ifdef SYS_memfd_create
+  fd = syscall(SYS_memfd_create, "sstmac_globals", 0);
+  if (fd >= 0) return fd;
+#endif
+  //no memfd - fall back to an unlinked temp file
+  char name[] = "/tmp/sstmac_globals_XXXXXX";
+  fd = mkstemp(name);
+  if (fd < 0){
+    spkt_abort_printf("failed to create file for copy-on-write global segments: %s",
+                      ::strerror(errno));
+  }
+  ::unlink(name);
+  return fd;
+}
+
+/**
+ * Count the pages of a segment that have been written, i.e. no longer
+ * backed by the shared image. Without pagemap, assume every page was copied.
+ */
+static size_t private_resident_bytes(char* segment, size_t size)
+{
+  size_t num_pages = size / page_size();
+#ifdef __linux__
+  static int pagemap_fd = ::open("/proc/self/pagemap", O_RDONLY);
+  if (pagemap_fd >= 0){
+    std::vector<uint64_t> entries(num_pages);
+    off_t offset = ((uintptr_t)segment / page_size()) * sizeof(uint64_t);
+    ssize_t nbytes = num_pages * sizeof(uint64_t);
+    if (::pread(pagemap_fd, entries.data(), nbytes, offset) == nbytes){
+      static const uint64_t present = 1ULL << 63;
+      static const uint64_t file_page = 1ULL << 61;
+      size_t num_private = 0;
+      for (uint64_t e : entries){
+        if ((e & present) && !(e & file_page)) ++num_private;
+      }
+      return num_private * page_size();
+    }
+  }
+#endif
+  return num_pages * page_size();
+}
+
+void
+GlobalVariableContext::syncImage()
+{
+  if (imageFd_ < 0){
+    imageFd_ = create_image_file();
+  }
+
+  size_t rem = allocSize_ % page_size();
+  imageSize_ = rem ? allocSize_ + page_size() - rem : allocSize_;
+  if (::ftruncate(imageFd_, imageSize_) != 0 ||
+      ::pwrite(imageFd_, globalInits, stackOffset, 0) != stackOffset){
+    spkt_abort_printf("failed to write initial image of global variables: %s",
+                      ::strerror(errno));
+  }
+  imageSynced_ = true;
+}
+
+char*
+GlobalVariableContext::allocateSegment(bool copyOnWrite)
+{
+  if (allocSize_ == 0) return nullptr;
+
+  if (!copyOnWrite){
+    char* segment = new char[allocSize_];
+    ::memcpy(segment, globalInits, stackOffset);
+    return segment;
+  }
+
+  segment_lock.lock();
+  if (!imageSynced_ || imageFd_ < 0){
+    syncImage();
+  }
+  //private mapping - pages stay shared with the image until written
+  void* segment = ::mmap(nullptr, imageSize_, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, imageFd_, 0);
+  if (segment == MAP_FAILED){
+    segment_lock.unlock();
+    spkt_abort_printf("failed to map copy-on-write global segment of size %lu: %s",
+                      imageSize_, ::strerror(errno));
+  }
+  cowSegments_[segment] = imageSize_;
+  segment_lock.unlock();
+  return (char*) segment;
+}
+
+bool
+GlobalVariableContext::isCopyOnWrite(char* segment)
+{
+  segment_lock.lock();
+  bool cow = cowSegments_.find(segment) != cowSegments_.end();
+  segment_lock.unlock();
+  return cow;
+}
+
+void
+GlobalVariableContext::freeSegment(char* segment, int aid)
+{
+  if (!segment) return;
+
+  segment_lock.lock();
+  auto iter = cowSegments_.find(segment);
+  if (iter == cowSegments_.end()){
+    segment_lock.unlock();
+    delete[] segment;
+    return;
+  }
+
+  size_t size = iter->second;
+  cowSegments_.erase(iter);
+  usage& u = usage_[aid];
+  size_t resident = private_resident_bytes(segment, size);
+  u.num_segments++;
+  u.resident_bytes += resident;
+  u.mapped_bytes += size;
+  u.max_resident_bytes = std::max(u.max_resident_bytes, resident);
+  segment_lock.unlock();
+
+  ::munmap(segment, size);
+}
+
+void
+GlobalVariableContext::printUsage(const char* name, std::ostream& os)
+{
+  for (auto& pair : usage_){
+    const usage& u = pair.second;
+    os << sprockit::printf("App %d %s: %d copy-on-write segments, %lu of %lu mapped bytes resident"
+                           " (max %lu per segment), %lu byte shared image\n",
+                           pair.first, name, u.num_segments, u.resident_bytes,
+                           u.mapped_bytes, u.max_resident_bytes, imageSize_);
+  }
 }
 
 void
@@ -47,7 +47,11 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/software/process/tls.h>
 #include <list>
+#include <map>
+#include <cstring>
+#include <unordered_map>
 #include <unordered_set>
+#include <iosfwd>
 
 extern "C" int sstmac_global_stacksize;
 
@@ -90,6 +94,36 @@ class GlobalVariableContext {
 
   void initGlobalSpace(void* ptr, int size, int offset);
 
+  /**
+   * @brief allocateSegment Create a new segment holding the initial values of all globals
+   * @param copyOnWrite Privately map the segment from a shared image of the
+   *        initial values so pages are only duplicated once a rank writes them
+   * @return The segment, nullptr if the alloc size is zero
+   */
+  char* allocateSegment(bool copyOnWrite);
+
+  /**
+   * @brief freeSegment Release a segment returned by allocateSegment
+   * @param segment
+   * @param aid The app owning the segment, used for reporting memory usage
+   */
+  void freeSegment(char* segment, int aid);
+
+  /**
+   * @brief resetSegment Restore the initial values in a segment being reused
+   */
+  void resetSegment(char* segment){
+    ::memcpy(segment, globalInits, stackOffset);
+  }
+
+  bool isCopyOnWrite(char* segment);
+
+  /**
+   * @brief printUsage Report per-app resident memory of copy-on-write segments.
+   *        Does nothing if no copy-on-write segments were ever allocated.
+   */
+  void printUsage(const char* name, std::ostream& os);
+
   void relocatePointers(void* globals);
 
   void registerRelocation(void* srcPtr, void* srcBasePtr, int& srcOffset,
@@ -141,8 +175,30 @@ class GlobalVariableContext {
   std::list<relocationCfg> relocationCfgs;
 
  private:
+  void syncImage();
+
   std::unordered_set<void*> activeGlobalMaps_;
 
+  /** Anonymous file holding the initial values that copy-on-write segments map */
+  int imageFd_ = -1;
+  /** False whenever the initial values change after the image was written */
+  bool imageSynced_ = false;
+  size_t imageSize_ = 0;
+
+  /** The mapped length of each copy-on-write segment */
+  std::unordered_map<void*,size_t> cowSegments_;
+
+  struct usage {
+    int num_segments;
+    size_t resident_bytes;
+    size_t max_resident_bytes;
+    size_t mapped_bytes;
+    usage() : num_segments(0), resident_bytes(0),
+      max_resident_bytes(0), mapped_bytes(0) {}
+  };
+  /** Indexed by app id */
+  std::map<int,usage> usage_;
+
 };
 
 class GlobalVariable {
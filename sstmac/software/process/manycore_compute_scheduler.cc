@@ -0,0 +1,179 @@
+/**
+Copyright 2009-2018 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2018, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/software/process/manycore_compute_scheduler.h>
+#include <sstmac/software/process/operating_system.h>
+#include <sstmac/software/process/thread.h>
+#include <sprockit/errors.h>
+
+namespace sstmac {
+namespace sw {
+
+ManycoreComputeScheduler::ManycoreComputeScheduler(SST::Params& params, OperatingSystem* os,
+                                                   int ncore, int nsocket) :
+  ComputeScheduler(params, os, ncore, nsocket),
+  next_ticket_(0),
+  queues_by_core_(ncore)
+{
+  if (ncore > CpuMask::max_cores){
+    spkt_abort_printf("manycore compute scheduler supports at most %d cores, got %d",
+                      CpuMask::max_cores, ncore);
+  }
+  all_ = CpuMask::firstN(ncore);
+  free_ = all_;
+}
+
+void
+ManycoreComputeScheduler::allocate(int ncores, Thread* thr, const CpuMask& mask)
+{
+  CpuMask valid = free_ & mask;
+  int core = valid.findFirst();
+  for (int i=0; i < ncores; ++i){
+    thr->addActiveCore(core);
+    free_.clear(core);
+    core = valid.findFirst(core+1);
+  }
+  debug_printf(sprockit::dbg::compute_scheduler,
+      "Reserved %d cores for thread %ld - %d cores free",
+      ncores, thr->threadId(), free_.count());
+}
+
+ManycoreComputeScheduler::WaitQueue*
+ManycoreComputeScheduler::queueFor(const CpuMask& mask)
+{
+  auto& q = queues_[mask];
+  if (!q){
+    q = std::unique_ptr<WaitQueue>(new WaitQueue);
+    q->mask = mask;
+    for (int c=mask.findFirst(); c >= 0; c=mask.findFirst(c+1)){
+      queues_by_core_[c].push_back(q.get());
+    }
+  }
+  return q.get();
+}
+
+void
+ManycoreComputeScheduler::reserveCores(int ncores, Thread* thr)
+{
+  CpuMask mask = thr->cpumask() & all_;
+  if (mask.count() < ncores){
+    spkt_abort_printf("thread %ld needs %d cores, but its affinity only allows %d",
+                      thr->threadId(), ncores, mask.count());
+  }
+
+  WaitQueue* q = queueFor(mask);
+  //don't jump ahead of threads already waiting on the same cores
+  if (q->waiters.empty() && fits(ncores, mask)){
+    allocate(ncores, thr, mask);
+    return;
+  }
+
+  debug_printf(sprockit::dbg::compute_scheduler,
+      "Need %d cores for thread %ld, only %d match its affinity - blocking",
+      ncores, thr->threadId(), (free_ & mask).count());
+  Waiter w;
+  w.ncores = ncores;
+  w.thr = thr;
+  w.ticket = next_ticket_++;
+  q->waiters.push_back(w);
+  //cores have been assigned by the time this returns
+  os_->block();
+}
+
+int
+ManycoreComputeScheduler::nfreeCores(Thread* thr) const
+{
+  CpuMask mask = thr->cpumask() & all_;
+  auto iter = queues_.find(mask);
+  //free cores already promised to waiting threads are not up for grabs
+  if (iter != queues_.end() && !iter->second->waiters.empty()) return 0;
+  return (free_ & mask).count();
+}
+
+void
+ManycoreComputeScheduler::releaseCores(int ncores, Thread* thr)
+{
+  for (int i=0; i < ncores; ++i){
+    int core = thr->popActiveCore();
+    free_.set(core);
+    //only waiters that could use a released core can have become runnable
+    for (WaitQueue* q : queues_by_core_[core]){
+      if (!q->candidate && !q->waiters.empty()){
+        q->candidate = true;
+        candidates_.push_back(q);
+      }
+    }
+  }
+  debug_printf(sprockit::dbg::compute_scheduler,
+      "Released %d cores for thread %ld - %d cores free",
+      ncores, thr->threadId(), free_.count());
+
+  //hand cores to the longest waiting thread that fits until none does
+  std::vector<Thread*> to_unblock;
+  while (true){
+    WaitQueue* best = nullptr;
+    for (WaitQueue* q : candidates_){
+      if (q->waiters.empty()) continue;
+      const Waiter& w = q->waiters.front();
+      if ((!best || w.ticket < best->waiters.front().ticket) && fits(w.ncores, q->mask)){
+        best = q;
+      }
+    }
+    if (!best) break;
+
+    Waiter w = best->waiters.front();
+    best->waiters.pop_front();
+    allocate(w.ncores, w.thr, best->mask);
+    to_unblock.push_back(w.thr);
+  }
+
+  for (WaitQueue* q : candidates_) q->candidate = false;
+  candidates_.clear();
+
+  //unblocking can run the thread right away - finish bookkeeping first
+  for (Thread* t : to_unblock) os_->unblock(t);
+}
+
+}
+}
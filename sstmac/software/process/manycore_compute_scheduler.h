@@ -0,0 +1,119 @@
+/**
+Copyright 2009-2018 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2018, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef sstmac_software_process_manycore_compute_scheduler_h
+#define sstmac_software_process_manycore_compute_scheduler_h
+
+#include <sstmac/software/process/compute_scheduler.h>
+#include <sstmac/software/process/cpu_mask.h>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Affinity-aware scheduler for nodes with many cores.
+ * Free cores are a wide bitset searched a word at a time.
+ * Blocked threads wait FIFO in a queue per distinct affinity mask,
+ * and each core indexes the queues whose mask contains it, so
+ * releasing a core only looks at the waiters that could use it.
+ */
+class ManycoreComputeScheduler : public ComputeScheduler
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    ComputeScheduler,
+    ManycoreComputeScheduler,
+    "macro",
+    "manycore",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "Compute scheduler honoring CPU_SET affinity that scales to many cores")
+
+  ManycoreComputeScheduler(SST::Params& params, OperatingSystem* os,
+                           int ncore, int nsocket);
+
+  void reserveCores(int ncore, Thread* thr) override;
+
+  void releaseCores(int ncore, Thread* thr) override;
+
+  int nfreeCores(Thread* thr) const override;
+
+ private:
+  struct Waiter {
+    int ncores;
+    Thread* thr;
+    uint64_t ticket;
+  };
+
+  struct WaitQueue {
+    CpuMask mask;
+    std::deque<Waiter> waiters;
+    bool candidate;
+    WaitQueue() : candidate(false) {}
+  };
+
+  bool fits(int ncores, const CpuMask& mask) const {
+    return (free_ & mask).count() >= ncores;
+  }
+
+  void allocate(int ncores, Thread* thr, const CpuMask& mask);
+
+  WaitQueue* queueFor(const CpuMask& mask);
+
+  CpuMask free_;
+  CpuMask all_;
+  uint64_t next_ticket_;
+  std::unordered_map<CpuMask, std::unique_ptr<WaitQueue>, CpuMask::Hash> queues_;
+  //indexed by core, every queue whose mask contains that core
+  std::vector<std::vector<WaitQueue*>> queues_by_core_;
+  std::vector<WaitQueue*> candidates_;
+};
+
+}
+}
+
+#endif
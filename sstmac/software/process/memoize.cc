@@ -1,5 +1,10 @@
 #include <sstmac/software/process/memoize.h>
+#include <sstmac/software/process/memoize_db.h>
 #include <sstmac/software/process/operating_system.h>
+#include <sprockit/errors.h>
+#include <sprockit/util.h>
+#include <cstdio>
+#include <cstring>
 
 
 namespace sstmac {
@@ -9,6 +14,216 @@ Memoization::Memoization(const char* name, const char* model)
   sstmac::sw::OperatingSystem::addMemoization(name, model);
 }
 
+namespace sw {
+
+static const char memo_magic[8] = "SSTMEMO";
+static const uint32_t memo_version = 1;
+
+std::string MemoizeDatabase::file_;
+MemoizeDatabase::TokenMap MemoizeDatabase::loaded_;
+MemoizeDatabase::TokenMap MemoizeDatabase::fresh_;
+int MemoizeDatabase::nshards_ = 0;
+thread_lock MemoizeDatabase::lock_;
+
+template <class T>
+static void
+readVal(FILE* f, const std::string& file, T* t, size_t n = 1)
+{
+  if (fread(t, sizeof(T), n, f) != n){
+    spkt_abort_printf("memoization database %s is truncated", file.c_str());
+  }
+}
+
+template <class T>
+static void
+writeVal(FILE* f, const T* t, size_t n = 1)
+{
+  fwrite(t, sizeof(T), n, f);
+}
+
+void
+MemoizeDatabase::add(TokenMap& into, const std::string& token, int nparams,
+                     const std::vector<double>& params, uint64_t count, double total)
+{
+  TokenData& data = into[token];
+  if (data.nparams == -1){
+    data.nparams = nparams;
+  } else if (data.nparams != nparams){
+    spkt_abort_printf("memoization %s has %d parameters, but database has %d",
+                      token.c_str(), nparams, data.nparams);
+  }
+  Entry& e = data.entries[params];
+  e.count += count;
+  e.total += total;
+}
+
+void
+MemoizeDatabase::merge(TokenMap& into, const TokenMap& from)
+{
+  for (auto& tok : from){
+    for (auto& pair : tok.second.entries){
+      add(into, tok.first, tok.second.nparams, pair.first,
+          pair.second.count, pair.second.total);
+    }
+  }
 }
 
+bool
+MemoizeDatabase::read(const std::string& file, TokenMap& into)
+{
+  FILE* f = fopen(file.c_str(), "rb");
+  if (!f) return false;
+
+  char magic[8];
+  readVal(f, file, magic, 8);
+  if (::memcmp(magic, memo_magic, 8) != 0){
+    spkt_abort_printf("%s is not a memoization database", file.c_str());
+  }
+  uint32_t version;
+  readVal(f, file, &version);
+  if (version != memo_version){
+    spkt_abort_printf("memoization database %s has version %u, expected %u",
+                      file.c_str(), version, memo_version);
+  }
+
+  uint32_t ntokens;
+  readVal(f, file, &ntokens);
+  for (uint32_t t=0; t < ntokens; ++t){
+    uint32_t len;
+    readVal(f, file, &len);
+    std::string token(len, '\0');
+    readVal(f, file, &token[0], len);
+    uint32_t nparams;
+    uint64_t nentries;
+    readVal(f, file, &nparams);
+    readVal(f, file, &nentries);
+    std::vector<double> params(nparams);
+    for (uint64_t e=0; e < nentries; ++e){
+      uint64_t count;
+      double total;
+      readVal(f, file, params.data(), nparams);
+      readVal(f, file, &count);
+      readVal(f, file, &total);
+      add(into, token, nparams, params, count, total);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+void
+MemoizeDatabase::writeFile(const std::string& file, const TokenMap& data)
+{
+  //write to the side and rename so an interrupted run never leaves a torn file
+  std::string tmp = file + ".tmp";
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if (!f){
+    spkt_abort_printf("could not open memoization database %s for writing", tmp.c_str());
+  }
+
+  writeVal(f, memo_magic, 8);
+  writeVal(f, &memo_version);
+  uint32_t ntokens = data.size();
+  writeVal(f, &ntokens);
+  for (auto& tok : data){
+    uint32_t len = tok.first.size();
+    writeVal(f, &len);
+    writeVal(f, tok.first.data(), len);
+    uint32_t nparams = tok.second.nparams;
+    uint64_t nentries = tok.second.entries.size();
+    writeVal(f, &nparams);
+    writeVal(f, &nentries);
+    for (auto& pair : tok.second.entries){
+      writeVal(f, pair.first.data(), nparams);
+      writeVal(f, &pair.second.count);
+      writeVal(f, &pair.second.total);
+    }
+  }
+
+  if (fclose(f) != 0 || ::rename(tmp.c_str(), file.c_str()) != 0){
+    spkt_abort_printf("failed writing memoization database %s", file.c_str());
+  }
+}
 
+void
+MemoizeDatabase::load(const std::string& file)
+{
+  lock_.lock();
+  if (!file_.empty()){
+    lock_.unlock();
+    if (file != file_){
+      spkt_abort_printf("all nodes must use the same memoization database: got %s and %s",
+                        file.c_str(), file_.c_str());
+    }
+    return;
+  }
+  file_ = file;
+  read(file_, loaded_);
+  while (read(sprockit::printf("%s.%d", file_.c_str(), nshards_), loaded_)){
+    ++nshards_;
+  }
+  lock_.unlock();
+}
+
+const MemoizeDatabase::TokenData*
+MemoizeDatabase::find(const std::string& token)
+{
+  auto iter = loaded_.find(token);
+  return iter == loaded_.end() ? nullptr : &iter->second;
+}
+
+bool
+MemoizeDatabase::contains(const std::string& token, int nparams, const double params[])
+{
+  const TokenData* data = find(token);
+  if (!data || data->nparams != nparams) return false;
+  std::vector<double> key(params, params + nparams);
+  return data->entries.find(key) != data->entries.end();
+}
+
+void
+MemoizeDatabase::record(const std::string& token, int nparams,
+                        const double params[], double time)
+{
+  std::vector<double> key(params, params + nparams);
+  lock_.lock();
+  add(fresh_, token, nparams, key, 1, time);
+  lock_.unlock();
+}
+
+void
+MemoizeDatabase::write(int me, int nproc)
+{
+  if (file_.empty()) return;
+
+  if (nproc == 1){
+    if (fresh_.empty() && nshards_ == 0) return;
+    merge(loaded_, fresh_);
+    writeFile(file_, loaded_);
+    for (int i=0; i < nshards_; ++i){
+      ::remove(sprockit::printf("%s.%d", file_.c_str(), i).c_str());
+    }
+    nshards_ = 0;
+  } else {
+    //shards from earlier runs hold samples not yet folded into the main file
+    //every rank writes one, even if empty, so that shard numbering has no gaps
+    std::string shard = sprockit::printf("%s.%d", file_.c_str(), me);
+    TokenMap data;
+    read(shard, data);
+    merge(data, fresh_);
+    writeFile(shard, data);
+  }
+  fresh_.clear();
+}
+
+void
+MemoizeDatabase::clear()
+{
+  file_.clear();
+  loaded_.clear();
+  fresh_.clear();
+  nshards_ = 0;
+}
+
+}
+}
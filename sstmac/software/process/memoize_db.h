@@ -0,0 +1,90 @@
+#ifndef sstmac_sw_process_memoize_db_h
+#define sstmac_sw_process_memoize_db_h
+
+#include <sstmac/common/thread_lock.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * On-disk store of timings collected for memoized compute regions.
+ * Samples are aggregated per token and parameter vector so the file
+ * stays small no matter how many times a region runs.
+ *
+ * File layout (host byte order):
+ *   char[8] magic "SSTMEMO", uint32 version, uint32 ntokens
+ *   per token: uint32 name length, name, uint32 nparams, uint64 nentries
+ *   per entry: double params[nparams], uint64 count, double total_seconds
+ *
+ * A run loads the file and any per-rank shards (file.0, file.1, ...)
+ * written by earlier parallel runs. A serial run writes everything back
+ * into the main file and folds the shards away. A parallel run appends
+ * only its new samples to its own shard, so ranks never race on a file.
+ */
+class MemoizeDatabase
+{
+ public:
+  struct Entry {
+    uint64_t count;
+    double total;
+    Entry() : count(0), total(0) {}
+  };
+
+  using Table = std::map<std::vector<double>, Entry>;
+
+  struct TokenData {
+    int nparams;
+    Table entries;
+    TokenData() : nparams(-1) {}
+  };
+
+  using TokenMap = std::map<std::string, TokenData>;
+
+  static void load(const std::string& file);
+
+  static bool active() {
+    return !file_.empty();
+  }
+
+  /**
+   * @return Samples loaded for the token from earlier runs, or null
+   */
+  static const TokenData* find(const std::string& token);
+
+  /**
+   * @return Whether earlier runs have samples for the token at these parameters
+   */
+  static bool contains(const std::string& token, int nparams, const double params[]);
+
+  static void record(const std::string& token, int nparams,
+                     const double params[], double time);
+
+  static void write(int me, int nproc);
+
+  static void clear();
+
+ private:
+  static bool read(const std::string& file, TokenMap& into);
+
+  static void writeFile(const std::string& file, const TokenMap& data);
+
+  static void merge(TokenMap& into, const TokenMap& from);
+
+  static void add(TokenMap& into, const std::string& token, int nparams,
+                  const std::vector<double>& params, uint64_t count, double total);
+
+  static std::string file_;
+  static TokenMap loaded_;
+  static TokenMap fresh_;
+  static int nshards_;
+  static thread_lock lock_;
+};
+
+}
+}
+
+#endif
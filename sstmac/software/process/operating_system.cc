@@ -64,6 +64,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/progress_queue.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/compute_scheduler.h>
+#include <sstmac/software/process/memoize_db.h>
 #include <sstmac/software/process/thread_info.h>
 #include <sstmac/software/launch/app_launcher.h>
 #include <sstmac/software/libraries/unblock_event.h>
@@ -101,6 +102,8 @@ RegisterKeywords(
 { "callGraph", "DEPRECATED: sets the fileroot of the call graph statistic" },
 { "compute_scheduler", "the type of compute scheduler or assigning cores to computation" },
 { "context", "the user-space thread context library" },
+{ "memoize_db", "file storing timings of memoized compute regions across runs" },
+{ "memoize_retime", "whether to keep timing memoized regions that already have samples" },
 );
 
 #include <sstmac/software/process/gdb.h>
@@ -148,70 +151,64 @@ struct NullImplicitState : public OperatingSystem::ImplicitState
   void unsetState(int type) override {}
 };
 
-struct NullRegression : public OperatingSystem::ThreadSafeTimerModel<double>
+struct NullRegression : public OperatingSystem::ThreadSafeTimerModel
 {
-  /**
+#if !SSTMAC_INTEGRATED_SST_CORE
   SST_ELI_REGISTER_DERIVED(
     OperatingSystem::RegressionModel,
     NullRegression,
     "macro",
     "null",
     SST_ELI_ELEMENT_VERSION(1,0,0),
-    "a regression model that does nothing")
-  */
+    "a regression model that returns the mean of all samples")
+#endif
 
-  using Parent = OperatingSystem::ThreadSafeTimerModel<double>;
+  using Parent = OperatingSystem::ThreadSafeTimerModel;
 
   NullRegression(SST::BaseComponent* comp, const std::string& key,
                  const std::string& subName, SST::Params& params)
-    : Parent(params, comp, key, ""), computed_(false) {}
+    : Parent(params, comp, key, ""), count_(0), total_(0) {}
 
   double compute(int n_params, const double params[],
                  OperatingSystem::ImplicitState* state) override {
-    if (!computed_){
-      computed_ = true;
-      computeMean();
+    if (count_ == 0){
+      spkt_abort_printf("memoization %s has no samples to compute from", key().c_str());
     }
-    return mean_;
+    return total_ / count_;
   }
 
   int startCollection() override {
     return Parent::start();
   }
 
-  void finishCollection(int thr_tag, int n_params, const double params[],
-                         OperatingSystem::ImplicitState* state) override {
-    Parent::finish(thr_tag);
+  double finishCollection(int thr_tag, int n_params, const double params[],
+                          OperatingSystem::ImplicitState* state) override {
+    double t = Parent::finish(thr_tag);
+    addSamples(n_params, params, 1, t);
+    return t;
   }
 
-  /**
-  void finalize(sstmac::Timestamp t) override {
-    compute_mean();
-    std::string file = key() + ".memo";
-    std::ofstream ofs(file);
-    ofs << key()
-        << "\n" << mean_;
-    ofs.close();
+  void addSamples(int n_params, const double params[],
+                  uint64_t count, double total) override {
+    lock();
+    count_ += count;
+    total_ += total;
+    unlock();
   }
-  */
 
  private:
-  void computeMean(){
-    double total = 0;
-    for (double d : samples_){
-      total += d;
-    }
-    mean_ = total / samples_.size();
-  }
-
-  double mean_;
-  bool computed_;
+  uint64_t count_;
+  double total_;
 
 };
 
-struct LinearRegression : public OperatingSystem::ThreadSafeTimerModel<std::pair<double,double>>
+/**
+ * Least-squares fit of time = m*x + b. Only the running sums are kept
+ * so that samples loaded from a memoization database cost nothing to store.
+ */
+struct LinearRegression : public OperatingSystem::ThreadSafeTimerModel
 {
-  /**
+#if !SSTMAC_INTEGRATED_SST_CORE
   SST_ELI_REGISTER_DERIVED(
     OperatingSystem::RegressionModel,
     LinearRegression,
@@ -219,79 +216,65 @@ struct LinearRegression : public OperatingSystem::ThreadSafeTimerModel<std::pair
     "linear",
     SST_ELI_ELEMENT_VERSION(1,0,0),
     "a simple linear regression model")
-  */
+#endif
 
-  using parent = OperatingSystem::ThreadSafeTimerModel<std::pair<double,double>>;
+  using parent = OperatingSystem::ThreadSafeTimerModel;
   LinearRegression(SST::BaseComponent* comp, const std::string& key,
                    const std::string& subName, SST::Params& params)
-    : parent(params, comp, key, ""), computed_(false) {}
+    : parent(params, comp, key, ""),
+      n_(0), sumX_(0), sumY_(0), sumXX_(0), sumXY_(0) {}
 
   double compute(int n_params, const double params[],
                  OperatingSystem::ImplicitState* state) override {
     if (n_params != 1){
       spkt_abort_printf("linear regression can only take one parameter - got %d", n_params);
     }
-    if (!computed_){
-      computeRegression();
-      computed_ = true;
+    if (n_ == 0){
+      spkt_abort_printf("memoization %s has no samples to compute from", key().c_str());
     }
-    double val = m_*params[0] + b_;
-    //std::cout << "Computed " << key() << "->f(" << params[0] << ") = " << val << std::endl;
-    return val;
+    double meanX = sumX_ / n_;
+    double meanY = sumY_ / n_;
+    double var = sumXX_ - n_*meanX*meanX;
+    double cov = sumXY_ - n_*meanX*meanY;
+    //all samples at the same x - the best we can do is the mean
+    double m = var > 0 ? cov / var : 0;
+    double b = meanY - m*meanX;
+    return m*params[0] + b;
   }
 
   int startCollection() override {
     return parent::start();
   }
 
-  void finishCollection(int thr_tag, int n_params, const double params[],
-                        OperatingSystem::ImplicitState* state) override {
+  double finishCollection(int thr_tag, int n_params, const double params[],
+                          OperatingSystem::ImplicitState* state) override {
+    double t = parent::finish(thr_tag);
+    addSamples(n_params, params, 1, t);
+    return t;
+  }
+
+  void addSamples(int n_params, const double params[],
+                  uint64_t count, double total) override {
     if (n_params != 1){
       spkt_abort_printf("linear regression can only take one parameter - got %d", n_params);
     }
-    parent::finish(thr_tag, params[0]);
+    //count samples at x that sum to total contribute count*x, total, ...
+    double x = params[0];
+    lock();
+    n_ += count;
+    sumX_ += count*x;
+    sumY_ += total;
+    sumXX_ += count*x*x;
+    sumXY_ += x*total;
+    unlock();
   }
 
-  /**
-  void finalize(sstmac::Timestamp t) override {
-    computeRegression();
-    std::string file = key() + ".memo";
-    std::ofstream ofs(file);
-    ofs << key()
-        << "\n" << m_
-        << "\n" << b_;
-    ofs.close();
-  }
-  */
-
  private:
-  void computeRegression(){
-    double meanX = 0;
-    double meanY = 0;
-    for (auto& pair : samples_){
-      meanX += pair.second;
-      meanY += pair.second;
-    }
-    meanX /= samples_.size();
-    meanY /= samples_.size();
-
-    double Cov = 0;
-    double Var = 0;
-    for (auto& pair : samples_){
-      double dx = pair.first - meanX;
-      double dy = pair.second - meanY;
-      Var += dx*dx;
-      Cov += dx*dy;
-    }
-
-    b_ = Cov / Var;
-    m_ = meanY - b_*meanX;
-    //std::cout << "Computed " << key() << "-> m=" << m_ << " b=" << b_ << std::endl;
-  }
-
-  double m_;
-  double b_;
-  bool computed_;
+  double n_;
+  double sumX_;
+  double sumY_;
+  double sumXX_;
+  double sumXY_;
 };
 
 static sprockit::NeedDeletestatics<OperatingSystem> del_statics;
@@ -310,6 +293,7 @@ std::unordered_map<uint32_t,Thread*> OperatingSystem::all_threads_;
 bool OperatingSystem::gdb_active_ = false;
 std::map<std::string,std::unique_ptr<OperatingSystem::RegressionModel>> OperatingSystem::memoize_models_;
 std::unique_ptr<std::map<std::string,std::string>> OperatingSystem::memoize_init_ = nullptr;
+bool OperatingSystem::memoize_retime_ = false;
 
 OperatingSystem::OperatingSystem(SST::Params& params, hw::Node* parent) :
 #if SSTMAC_INTEGRATED_SST_CORE
@@ -324,6 +308,7 @@ OperatingSystem::OperatingSystem(SST::Params& params, hw::Node* parent) :
   callGraph_(nullptr),
   callGraph_active_(true), //on by default
   des_context_(nullptr),
+  free_tls_size_(0),
   ftq_trace_(nullptr),
   compute_sched_(nullptr),
   SubComponent("os", parent),
@@ -348,6 +333,10 @@ OperatingSystem::OperatingSystem(SST::Params& params, hw::Node* parent) :
 
   StackAlloc::init(params);
 
+  if (params.contains("memoize_db")){
+    MemoizeDatabase::load(params.find<std::string>("memoize_db"));
+    memoize_retime_ = params.find<bool>("memoize_retime", false);
+  }
   rebuildMemoizations();
 
   SST::Params env_params = params.find_scoped_params("env");
@@ -372,6 +361,13 @@ OperatingSystem::rebuildMemoizations()
       auto* model = sprockit::create<RegressionModel>(
         "macro", pair.second, node(), pair.first, "", memo_params);
       memoize_models_[pair.first] = std::unique_ptr<RegressionModel>(model);
+      auto* loaded = MemoizeDatabase::find(pair.first);
+      if (loaded){
+        for (auto& entry : loaded->entries){
+          model->addSamples(loaded->nparams, entry.first.data(),
+                            entry.second.count, entry.second.total);
+        }
+      }
       //EventManager::global->registerStat(model, nullptr);
     }
 #else
@@ -403,6 +399,12 @@ OperatingSystem::deallocateCore(Thread *thr)
   compute_sched_->releaseCores(1, thr);
 }
 
+int
+OperatingSystem::nfreeCores() const
+{
+  return compute_sched_->nfreeCores(active_thread_);
+}
+
 void
 OperatingSystem::initThreads(int nthread)
 {
@@ -432,6 +434,8 @@ OperatingSystem::~OperatingSystem()
     des_context_->destroyContext();
     delete des_context_;
   }
+  for (ThreadContext* ctx : free_contexts_) delete ctx;
+  for (char* tls : free_tls_) delete[] tls;
   if (compute_sched_) delete compute_sched_;
 
 #if SSTMAC_HAVE_GRAPHVIZ
@@ -600,6 +604,10 @@ OperatingSystem::switchToThread(Thread* tothread)
 
   /** back to main thread */
   active_thread_ = nullptr;
+  //don't hold the stack of a finished thread while it waits to be joined
+  if (tothread->getState() == Thread::DONE){
+    tothread->releaseStack();
+  }
 }
 
 void
@@ -644,9 +652,18 @@ OperatingSystem::stopMemoize(int thr_tag, const char *token, int n_params, doubl
                       token);
   }
 
+  if (!memoize_retime_ && MemoizeDatabase::contains(token, n_params, params)){
+    //earlier runs already timed these parameters, don't count them again
+    iter->second->cancelCollection(thr_tag);
+    return;
+  }
+
   uintptr_t localStorage = get_sstmac_tls();
   auto* states = (ImplicitState*)(localStorage + SSTMAC_TLS_IMPLICIT_STATE);
-  iter->second->finishCollection(thr_tag, n_params, params, states);
+  double time = iter->second->finishCollection(thr_tag, n_params, params, states);
+  if (MemoizeDatabase::active()){
+    MemoizeDatabase::record(token, n_params, params, time);
+  }
 }
 
 void
@@ -765,6 +782,56 @@ OperatingSystem::scheduleThreadDeletion(Thread* thr)
   sendExecutionEventNow(new DeleteThreadEvent(thr));
 }
 
+ThreadContext*
+OperatingSystem::allocateContext()
+{
+  if (free_contexts_.empty()){
+    return des_context_->copy();
+  }
+  ThreadContext* ctx = free_contexts_.back();
+  free_contexts_.pop_back();
+  return ctx;
+}
+
+void
+OperatingSystem::recycleContext(ThreadContext* ctx)
+{
+  ctx->destroyContext();
+  free_contexts_.push_back(ctx);
+}
+
+char*
+OperatingSystem::allocateTls(App* parent)
+{
+  GlobalVariableContext& ctx = GlobalVariable::tlsCtx;
+  if (free_tls_size_ != ctx.allocSize()){
+    //the TLS has been resized, pooled blocks no longer fit
+    for (char* tls : free_tls_) delete[] tls;
+    free_tls_.clear();
+    free_tls_size_ = ctx.allocSize();
+  }
+
+  if (free_tls_.empty() || parent->cowSegments()){
+    return (char*) parent->newTlsStorage();
+  }
+  char* tls = free_tls_.back();
+  free_tls_.pop_back();
+  ctx.resetSegment(tls);
+  return tls;
+}
+
+void
+OperatingSystem::recycleTls(char* tls, int aid)
+{
+  GlobalVariableContext& ctx = GlobalVariable::tlsCtx;
+  if (free_tls_size_ != ctx.allocSize() || ctx.isCopyOnWrite(tls)){
+    //only plain blocks of the current size get reused
+    ctx.freeSegment(tls, aid);
+  } else {
+    free_tls_.push_back(tls);
+  }
+}
+
 void
 OperatingSystem::completeActiveThread()
 {
@@ -951,10 +1018,14 @@ OperatingSystem::startThread(Thread* t)
       parent->params(),
       threadId(),
       des_context_,
+      allocateContext(),
       stack,
       StackAlloc::stacksize(),
       parent->globalsStorage(),
-      parent->newTlsStorage());
+      allocateTls(parent));
+    if (t->getState() == Thread::DONE){
+      t->releaseStack();
+    }
   }
 
   if (gdb_active_){
@@ -134,19 +134,41 @@ class OperatingSystem : public SubComponent
      */
     virtual int startCollection() = 0;
 
-    virtual void finishCollection(int thr_tag, int n_params, const double params[],
-                                   OperatingSystem::ImplicitState* state) = 0;
+    /**
+     * @brief finishCollection
+     * @return The host time measured since the matching startCollection
+     */
+    virtual double finishCollection(int thr_tag, int n_params, const double params[],
+                                    OperatingSystem::ImplicitState* state) = 0;
+
+    /**
+     * @brief cancelCollection Stop a collection without adding its sample
+     */
+    virtual void cancelCollection(int thr_tag) = 0;
+
+    /**
+     * @brief addSamples Fold in timings collected elsewhere, e.g. a memoization database
+     * @param count The number of samples at this parameter point
+     * @param total The summed time of all samples
+     */
+    virtual void addSamples(int n_params, const double params[],
+                            uint64_t count, double total) = 0;
 
     void addData_impl(int tag, int n, const double params[],
                       OperatingSystem::ImplicitState* state) override {
       finishCollection(tag, n, params, state);
     }
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+    void registerOutputFields(StatisticFieldsOutput* statOutput) override {}
+
+    void outputStatisticData(StatisticFieldsOutput* output, bool endOfSimFlag) override {}
+#endif
+
    private:
     std::string key_;
   };
 
-  template <class Sample>
   struct ThreadSafeTimerModel : public RegressionModel
   {
     ThreadSafeTimerModel(SST::Params& params, SST::BaseComponent* comp,
@@ -163,19 +185,18 @@ class OperatingSystem : public SubComponent
       return slot;
     }
 
-    template <class... Args>
-    void finish(int thr_tag, Args&&... args){
+    double finish(int thr_tag){
       double timer = sstmacWallTime();
       double t_total = timer - timers_[thr_tag];
-      lock();
-      samples_.emplace_back(std::forward<Args>(args)..., t_total);
-      freeSlotNoLock(thr_tag);
-      unlock();
+      freeSlot(thr_tag);
+      return t_total;
     }
 
-   protected:
-    std::vector<Sample> samples_;
+    void cancelCollection(int thr_tag) override {
+      freeSlot(thr_tag);
+    }
 
+   protected:
     void lock(){
       lock_.lock();
     }
@@ -237,6 +258,11 @@ class OperatingSystem : public SubComponent
     return active_thread_;
   }
 
+  /**
+   * @return How many more cores the active thread could reserve without blocking
+   */
+  int nfreeCores() const;
+
   int threadId() const {
     return thread_id_;
   }
@@ -329,6 +355,19 @@ class OperatingSystem : public SubComponent
 
   void scheduleThreadDeletion(Thread* thr);
 
+  /**
+   * @brief recycleContext Return the context of a finished thread
+   *        to be reused by the next thread started on this OS
+   */
+  void recycleContext(ThreadContext* ctx);
+
+  /**
+   * @brief recycleTls Return the TLS block of a finished thread
+   *        to be reused by the next thread started on this OS
+   * @param aid The app owning the block
+   */
+  void recycleTls(char* tls, int aid);
+
   void rebuildMemoizations();
 
   /**
@@ -474,6 +513,10 @@ class OperatingSystem : public SubComponent
   void allocateCore(Thread* thr);
   void deallocateCore(Thread* thr);
 
+  ThreadContext* allocateContext();
+
+  char* allocateTls(App* parent);
+
 
   int thread_id_;
   int nthread_;
@@ -491,6 +534,12 @@ class OperatingSystem : public SubComponent
   /// to this context on every context switch.
   ThreadContext *des_context_;
 
+  /// Contexts and TLS blocks of finished threads, reset in place
+  /// when the next thread starts rather than allocated again
+  std::vector<ThreadContext*> free_contexts_;
+  std::vector<char*> free_tls_;
+  int free_tls_size_;
+
   SST::Params params_;
 
   ComputeScheduler* compute_sched_;
@@ -503,6 +552,7 @@ class OperatingSystem : public SubComponent
 
   static std::map<std::string, std::unique_ptr<RegressionModel>> memoize_models_;
   static std::unique_ptr<std::map<std::string, std::string>> memoize_init_;
+  static bool memoize_retime_;
 
   static std::unordered_map<uint32_t, Thread*> all_threads_;
   static bool hold_for_gdb_;
@@ -70,6 +70,10 @@ class SimpleComputeScheduler : public ComputeScheduler
   
   void releaseCores(int ncore, Thread* thr) override;
 
+  int nfreeCores(Thread* thr) const override {
+    return ncores_ - ncore_active_;
+  }
+
  private:
   std::list<std::pair<int,Thread*>> pending_threads_;
   int ncore_active_;
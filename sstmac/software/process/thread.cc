@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/key.h>
 #include <sstmac/software/process/app.h>
+#include <sstmac/software/process/global.h>
 #include <sstmac/software/libraries/library.h>
 #include <sstmac/software/libraries/compute/compute_event.h>
 #include <sstmac/software/api/api.h>
@@ -74,8 +75,8 @@ static thread_safe_u32 THREAD_ID_CNT(0);
 //
 void
 Thread::initThread(const SST::Params& params,
-  int physical_thread_id, ThreadContext* des_thread, void *stack,
-  int stacksize, void* globals_storage, void* tls_storage)
+  int physical_thread_id, ThreadContext* des_thread, ThreadContext* context,
+  void *stack, int stacksize, void* globals_storage, void* tls_storage)
 {
   ThreadInfo::registerUserSpaceVirtualThread(physical_thread_id, stack,
                                              globals_storage, tls_storage);
@@ -85,7 +86,7 @@ Thread::initThread(const SST::Params& params,
 
   state_ = INITIALIZED;
 
-  context_ = des_thread->copy();
+  context_ = context;
 
   tls_storage_ = (char*) tls_storage;
 
@@ -103,6 +104,11 @@ Thread::current()
 void
 Thread::cleanup()
 {
+  if (host_timer_){
+    //charge compute since the last API call and anything still batched
+    startAPICall();
+  }
+
   if (parent_app_){
     if (detach_state_ == DETACHED && state_ != CANCELED){
       parent_app_->removeSubthread(this);
@@ -172,7 +178,6 @@ Thread::Thread(const SST::Params& params, SoftwareId sid, OperatingSystem* os) :
   thread_id_(Thread::main_thread),
   p_txt_(ProcessContext::none),
   context_(nullptr),
-  cpumask_(0),
   host_timer_(nullptr),
   parent_app_(nullptr),
   timed_out_(false),
@@ -182,24 +187,37 @@ Thread::Thread(const SST::Params& params, SoftwareId sid, OperatingSystem* os) :
   ftag_(FTQTag::null),
   protect_tag(false),
   tls_storage_(nullptr),
-  detach_state_(DETACHED),
-  active_core_mask_(0)
+  detach_state_(DETACHED)
 {
   //make all cores possible active
-  cpumask_ = ~(cpumask_);
+  cpumask_ = CpuMask::all();
 }
 
 void
-Thread::startAPICall()
+Thread::startAPICall(bool cheap)
 {
   if (host_timer_){
     double duration = host_timer_->stamp();
     debug_printf(sprockit::dbg::host_compute,
                  "host compute for %12.8es", duration);
-    parentApp()->compute(Timestamp(duration));
+    host_compute_pending_ += Timestamp(duration);
+    if (!cheap || host_compute_pending_ >= host_compute_batch_){
+      flushHostCompute();
+    }
   }
 }
 
+void
+Thread::flushHostCompute()
+{
+  if (host_compute_pending_.ticks() == 0) return;
+
+  //zero first - compute blocks and can come back through here
+  Timestamp t = host_compute_pending_;
+  host_compute_pending_ = Timestamp();
+  parentApp()->compute(t);
+}
+
 void
 Thread::endAPICall()
 {
@@ -273,6 +291,7 @@ Thread::spawn(Thread* thr)
   if (host_timer_){
     thr->host_timer_ = new HostTimer;
     thr->host_timer_->start();
+    thr->host_compute_batch_ = host_compute_batch_;
   }
   os_->startThread(thr);
 }
@@ -283,14 +302,23 @@ Thread::now()
   return os_->now();
 }
 
-Thread::~Thread()
+void
+Thread::releaseStack()
 {
-  if (stack_) StackAlloc::free(stack_);
-  if (context_) {
-    context_->destroyContext();
-    delete context_;
+  if (stack_){
+    StackAlloc::recordUsage(stack_, sid_.app_, sid_.task_);
+    StackAlloc::free(stack_);
   }
-  if (tls_storage_) delete[] tls_storage_;
+  stack_ = nullptr;
+  if (context_) os_->recycleContext(context_);
+  context_ = nullptr;
+  if (tls_storage_) os_->recycleTls(tls_storage_, sid_.app_);
+  tls_storage_ = nullptr;
+}
+
+Thread::~Thread()
+{
+  releaseStack();
   if (host_timer_) delete host_timer_;
 }
 
@@ -332,6 +360,15 @@ Thread::computeDetailed(uint64_t flops, uint64_t nintops, uint64_t bytes, int nt
   parentApp()->computeDetailed(flops, nintops, bytes, used_nthread);
 }
 
+void
+Thread::computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+                           uint64_t flops, uint64_t nintops, uint64_t bytes, int nthread)
+{
+  omp_context& active = omp_contexts_.back();
+  int used_nthread = nthread == use_omp_num_threads ? active.requested_num_subthreads : nthread;
+  parentApp()->computeParallelFor(niter, schedule, chunk, flops, nintops, bytes, used_nthread);
+}
+
 void
 Thread::startThread(Thread* thr)
 {
@@ -340,7 +377,7 @@ Thread::startThread(Thread* thr)
 }
 
 void
-Thread::setCpumask(uint64_t cpumask)
+Thread::setCpumask(const CpuMask& cpumask)
 {
   cpumask_ = cpumask;
   os_->reassign_cores(this);
@@ -416,12 +453,8 @@ void stdMutex::lock()
   mutex_t* mut = parent_app_->getMutex(id_);
   if (mut == nullptr){
     spkt_abort_printf("error: bad mutex id for std::mutex: %d", id_);
-  } else if (mut->locked) {
-    mut->waiters.push_back(OperatingSystem::currentThread());
-    parent_app_->os()->block();
-  } else {
-    mut->locked = true;
   }
+  mut->lock(OperatingSystem::currentThread());
 }
 
 stdMutex::~stdMutex()
@@ -434,13 +467,8 @@ void stdMutex::unlock()
   mutex_t* mut = parent_app_->getMutex(id_);
   if (mut == nullptr || !mut->locked){
     return;
-  } else if (!mut->waiters.empty()){
-    Thread* blocker = mut->waiters.front();
-    mut->waiters.pop_front();
-    parent_app_->os()->unblock(blocker);
-  } else {
-    mut->locked = false;
   }
+  mut->unlock(OperatingSystem::currentThread());
 }
 
 bool stdMutex::try_lock()
@@ -448,11 +476,8 @@ bool stdMutex::try_lock()
   mutex_t* mut = parent_app_->getMutex(id_);
   if (mut == nullptr){
     return false;
-  } else if (mut->locked){
-    return false;
-  } else {
-    return true;
   }
+  return mut->tryLock();
 }
 
 }
@@ -58,6 +58,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/operating_system_fwd.h>
 #include <sstmac/software/process/thread_fwd.h>
 #include <sstmac/software/process/host_timer.h>
+#include <sstmac/software/process/cpu_mask.h>
 #include <sstmac/software/libraries/library_fwd.h>
 #include <sstmac/software/api/api_fwd.h>
 #include <sstmac/software/threading/threading_interface_fwd.h>
@@ -244,9 +245,16 @@ class Thread
   void collectBacktrace(int nfxn);
 
   void initThread(const SST::Params& params, int phyiscal_thread_id,
-    ThreadContext* tocopy, void *stack, int stacksize,
+    ThreadContext* des_thread, ThreadContext* context, void *stack, int stacksize,
     void* globals_storage, void* tls_storage);
 
+  /**
+   * Give back the stack, context and TLS of a thread that has finished running.
+   * A joinable thread can otherwise hold its stack until it is joined.
+   * This must be called from the DES thread, never on the thread itself.
+   */
+  void releaseStack();
+
   virtual void run() = 0;
 
   /** A convenience request to start a new thread.
@@ -272,29 +280,29 @@ class Thread
   }
   
   void addAffinity(int core){
-    cpumask_ = cpumask_ | (1<<core);
+    cpumask_.set(core);
   }
   
   void zeroAffinity(){
-    cpumask_ = 0;
+    cpumask_ = CpuMask();
   }
 
-  void setCpumask(uint64_t cpumask);
+  void setCpumask(const CpuMask& cpumask);
   
-  uint64_t cpumask() const {
+  const CpuMask& cpumask() const {
     return cpumask_;
   }
   
-  uint64_t activeCoreMask() const {
+  const CpuMask& activeCoreMask() const {
     return active_core_mask_;
   }
 
-  static inline void addCore(int core, uint64_t& mask){
-    mask = mask | (1<<core);
+  static inline void addCore(int core, CpuMask& mask){
+    mask.set(core);
   }
 
-  static inline void removeCore(int core, uint64_t& mask){
-    mask = mask & ~(1<<core);
+  static inline void removeCore(int core, CpuMask& mask){
+    mask.clear(core);
   }
 
   void addActiveCore(int core){
@@ -316,6 +324,14 @@ class Thread
   void computeDetailed(uint64_t flops, uint64_t intops,
                         uint64_t bytes, int nthread=use_omp_num_threads);
 
+  /**
+   * Analytic OpenMP parallel for, see LibComputeInst::computeParallelFor.
+   * By default the team is as large as a new parallel region would get.
+   */
+  void computeParallelFor(uint64_t niter, int schedule, uint64_t chunk,
+                          uint64_t flops, uint64_t intops, uint64_t bytes,
+                          int nthread=use_omp_num_threads);
+
   int ompGetThreadNum() const {
     auto& active = omp_contexts_.back();
     return active.id;
@@ -362,10 +378,22 @@ class Thread
 
   GlobalTimestamp now();
 
-  void startAPICall();
+  /**
+   * Charge host-timed compute since the last API call. Compute stays
+   * batched across cheap calls until host_compute_batch is reached,
+   * and is always flushed before any other call.
+   * @param cheap Whether the call neither communicates nor blocks
+   */
+  void startAPICall(bool cheap = false);
 
   void endAPICall();
 
+  /**
+   * Charge any host-timed compute that has been batched up
+   * but not yet turned into a simulated delay
+   */
+  void flushHostCompute();
+
   void setTag(FTQTag t){
     if (!protect_tag)
         ftag_ = t;
@@ -429,6 +457,11 @@ class Thread
 
   HostTimer* host_timer_;
 
+  //host-timed compute not yet charged, flushed once it reaches host_compute_batch_
+  Timestamp host_compute_pending_;
+
+  Timestamp host_compute_batch_;
+
  private:
   API* getAppApi(const std::string& name) const;
 
@@ -454,9 +487,9 @@ class Thread
 
   ThreadContext* context_;
   
-  uint64_t cpumask_;
+  CpuMask cpumask_;
   
-  uint64_t active_core_mask_;
+  CpuMask active_core_mask_;
 
   uint64_t block_counter_;
 
@@ -48,7 +48,20 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/thread_lock.h>
 #include <sprockit/errors.h>
 #include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+
+RegisterKeywords(
+{ "paint_stacks", "fill thread stacks with a pattern to report how much of each stack was used" },
+{ "stack_size_file", "file holding a stack size recommended by a previous run with painted stacks" },
+{ "stack_reclaim_threshold", "the number of idle stacks to keep resident before giving memory back" },
+{ "stack_reclaim_advice", "how to give back idle stacks: dontneed or free" },
+{ "report_stack_memory", "print reserved and committed stack memory at the end of the run" },
+);
 
 namespace sstmac {
 namespace sw {
@@ -57,6 +70,29 @@ StackAlloc::chunk_set StackAlloc::chunks_;
 size_t StackAlloc::suggested_chunk_ = 0;
 size_t StackAlloc::stacksize_ = 0;
 bool StackAlloc::protect_stacks_ = false;
+bool StackAlloc::paint_stacks_ = false;
+std::string StackAlloc::stack_size_file_;
+std::map<int,StackAlloc::usage> StackAlloc::usage_;
+int StackAlloc::reclaim_threshold_ = -1;
+int StackAlloc::reclaim_advice_ = MADV_DONTNEED;
+bool StackAlloc::report_memory_ = false;
+
+static thread_lock lock;
+
+static const uint64_t stack_paint = 0xdeadbeefcafef00dULL;
+
+//the bottom of the stack holds the thread-local block, never paint over it
+static const size_t paint_offset = 4096;
+
+//stacks grow down - the lowest overwritten word is the high-water mark
+static uint64_t*
+paintedTop(void* stack, size_t stacksize)
+{
+  uint64_t* ptr = (uint64_t*) ((char*)stack + paint_offset);
+  uint64_t* end = (uint64_t*) ((char*)stack + stacksize);
+  while (ptr != end && *ptr == stack_paint) ++ptr;
+  return ptr;
+}
 
 void
 StackAlloc::init(SST::Params& params)
@@ -65,7 +101,18 @@ StackAlloc::init(SST::Params& params)
     return; //we are good
   }
 
-  sstmac_global_stacksize = params.find<SST::UnitAlgebra>("stack_size", "131072B").getRoundedValue();
+  stack_size_file_ = params.find<std::string>("stack_size_file", "");
+  std::string default_size = "131072B";
+  if (!stack_size_file_.empty() && !params.contains("stack_size")){
+    //use whatever a previous run found to be enough
+    std::ifstream in(stack_size_file_);
+    size_t recommended;
+    if (in >> recommended){
+      default_size = sprockit::printf("%luB", recommended);
+    }
+  }
+
+  sstmac_global_stacksize = params.find<SST::UnitAlgebra>("stack_size", default_size).getRoundedValue();
   //must be a multiple of 4096
   int stack_rem = sstmac_global_stacksize % 4096;
   if (stack_rem != 0){
@@ -76,6 +123,24 @@ StackAlloc::init(SST::Params& params)
   stacksize_ = sstmac_global_stacksize;
 
   protect_stacks_ = params.find<bool>("protect_stacks", false);
+  paint_stacks_ = params.find<bool>("paint_stacks", false);
+  report_memory_ = params.find<bool>("report_stack_memory", false);
+  reclaim_threshold_ = params.find<int>("stack_reclaim_threshold", -1);
+
+  std::string advice = params.find<std::string>("stack_reclaim_advice", "dontneed");
+  if (advice == "dontneed"){
+    reclaim_advice_ = MADV_DONTNEED;
+  } else if (advice == "free"){
+#ifdef MADV_FREE
+    reclaim_advice_ = MADV_FREE;
+#else
+    //pages are dropped right away rather than when memory is tight
+    reclaim_advice_ = MADV_DONTNEED;
+#endif
+  } else {
+    spkt_abort_printf("invalid stack_reclaim_advice %s: must be dontneed or free",
+                      advice.c_str());
+  }
 }
 
 void
@@ -86,6 +151,17 @@ StackAlloc::chunk_set::clear()
   }
   allocations.clear();
   available.clear();
+  uncommitted.clear();
+}
+
+void
+StackAlloc::clear()
+{
+  lock.lock();
+  chunks_.clear();
+  //allow init again with a different stack size
+  stacksize_ = 0;
+  lock.unlock();
 }
 
 //
@@ -94,25 +170,40 @@ StackAlloc::chunk_set::clear()
 void*
 StackAlloc::alloc()
 {
-  static thread_lock lock;
   lock.lock();
   if (stacksize_ == 0) {
     spkt_throw_printf(sprockit::ValueError, "stackalloc::stacksize was not initialized");
   }
 
-  if(chunks_.available.empty()){
-    // grab a new chunk.
-    chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, protect_stacks_);
-    chunks_.allocations.push_back(new_chunk);
-    void* buf = new_chunk->getNextStack();
-    while (buf != nullptr){
-      chunks_.available.push_back(buf);
-      buf = new_chunk->getNextStack();
+  void* buf;
+  bool fresh = false;
+  if (!chunks_.available.empty()){
+    //most recently used stack, its pages are most likely still resident
+    buf = chunks_.available.back();
+    chunks_.available.pop_back();
+  } else {
+    if (chunks_.uncommitted.empty()){
+      // grab a new chunk.
+      chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, protect_stacks_);
+      chunks_.allocations.push_back(new_chunk);
+      void* next = new_chunk->getNextStack();
+      while (next != nullptr){
+        chunks_.uncommitted.push_back(next);
+        next = new_chunk->getNextStack();
+      }
     }
+    buf = chunks_.uncommitted.back();
+    chunks_.uncommitted.pop_back();
+    fresh = true;
   }
-  void *buf = chunks_.available.back();
-  chunks_.available.pop_back();
   lock.unlock();
+
+  //reused stacks were repainted when they were freed
+  if (paint_stacks_ && fresh){
+    uint64_t* start = (uint64_t*) ((char*)buf + paint_offset);
+    uint64_t* end = (uint64_t*) ((char*)buf + stacksize_);
+    std::fill(start, end, stack_paint);
+  }
   return buf;
 }
 
@@ -121,12 +212,89 @@ StackAlloc::alloc()
 //
 void StackAlloc::free(void* buf)
 {
-  static thread_lock lock; 
+  if (paint_stacks_){
+    //only the pages the last user dirtied need painting again
+    uint64_t* end = (uint64_t*) ((char*)buf + stacksize_);
+    std::fill(paintedTop(buf, stacksize_), end, stack_paint);
+  }
+
   lock.lock();
   chunks_.available.push_back(buf);
+  if (reclaim_threshold_ >= 0 && chunks_.available.size() > size_t(reclaim_threshold_)){
+    //give back the pages of the stack that has been idle longest
+    void* idle = chunks_.available.front();
+    chunks_.available.pop_front();
+    ::madvise(idle, stacksize_, reclaim_advice_);
+    chunks_.uncommitted.push_back(idle);
+  }
   lock.unlock();
 }
 
+void
+StackAlloc::recordUsage(void* stack, int aid, int rank)
+{
+  if (!paint_stacks_) return;
+
+  char* end = (char*)stack + stacksize_;
+  size_t used = end - (char*)paintedTop(stack, stacksize_);
+
+  lock.lock();
+  usage& u = usage_[aid];
+  if (used > u.max_bytes){
+    u.max_bytes = used;
+    u.max_rank = rank;
+  }
+  u.total_bytes += used;
+  u.num_stacks++;
+  lock.unlock();
+}
+
+void
+StackAlloc::printUsage(std::ostream& os)
+{
+  if (report_memory_){
+    size_t reserved = 0;
+    size_t committed = 0;
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> resident;
+    for (chunk* ch : chunks_.allocations){
+      reserved += ch->size();
+      size_t npages = (ch->size() + page_size - 1) / page_size;
+      resident.resize(npages);
+      if (::mincore(ch->addr(), ch->size(), resident.data()) == 0){
+        for (unsigned char r : resident) committed += (r & 1) * page_size;
+      }
+    }
+    os << sprockit::printf("Stack memory: %lu bytes reserved, %lu bytes committed, "
+                           "%lu idle stacks resident, %lu uncommitted\n",
+                           reserved, committed, chunks_.available.size(),
+                           chunks_.uncommitted.size());
+  }
+
+  if (!paint_stacks_) return;
+
+  size_t max_used = 0;
+  for (auto& pair : usage_){
+    const usage& u = pair.second;
+    os << sprockit::printf("App %d stack usage: max %lu bytes on rank %d, mean %lu bytes over %d threads\n",
+                           pair.first, u.max_bytes, u.max_rank,
+                           u.num_stacks ? u.total_bytes / u.num_stacks : 0, u.num_stacks);
+    max_used = std::max(max_used, u.max_bytes);
+  }
+
+  //leave 25% headroom above the deepest stack plus the reserved page, rounded to pages
+  size_t recommended = paint_offset + max_used + max_used / 4;
+  size_t rem = recommended % 4096;
+  if (rem) recommended += 4096 - rem;
+  os << sprockit::printf("Stack size %lu bytes, recommended stack_size = %luB\n",
+                         stacksize_, recommended);
+
+  if (!stack_size_file_.empty()){
+    std::ofstream out(stack_size_file_);
+    out << recommended << std::endl;
+  }
+}
+
 
 } // end pf namespace sw
 } // end of namespace sstmac
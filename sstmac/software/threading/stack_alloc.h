@@ -47,6 +47,10 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <cstring>
 #include <vector>
+#include <deque>
+#include <map>
+#include <iosfwd>
+#include <string>
 #include <sprockit/sim_parameters_fwd.h>
 
 namespace sstmac {
@@ -58,8 +62,10 @@ namespace sw {
  * which allocates uniform-size chunks (with the NX bit unset)
  * and sets guard pages on each side of the allocated stacks.
  *
- * This allocator does not return memory to the system until it is
- * deleted, but regions can be allocated and free-d repeatedly.
+ * Address space is only reserved up front - stack pages are committed
+ * when first touched. Idle stacks beyond a configurable number are
+ * returned to the system with madvise, but their address space is
+ * kept until the allocator is cleared.
  */
 class StackAlloc
 {
@@ -67,7 +73,10 @@ class StackAlloc
   class chunk;
   struct chunk_set {
     std::vector<chunk*> allocations;
-    std::vector<void*> available;
+    /// Free stacks that may still have resident pages, oldest first
+    std::deque<void*> available;
+    /// Free stacks that were never touched or were already reclaimed
+    std::vector<void*> uncommitted;
     ~chunk_set(){
       clear();
     }
@@ -81,6 +90,26 @@ class StackAlloc
   static size_t stacksize_;
   /// Optionally added a protected stack between each stack we return
   static bool protect_stacks_;
+  /// Fill stacks with a known pattern to measure how much of them gets used
+  static bool paint_stacks_;
+  /// Where the recommended stack size is saved, and read back by later runs
+  static std::string stack_size_file_;
+  /// Number of idle stacks to keep resident, negative to never reclaim
+  static int reclaim_threshold_;
+  /// The madvise advice for giving back idle stacks
+  static int reclaim_advice_;
+  /// Print reserved and committed stack memory at the end of the run
+  static bool report_memory_;
+
+  struct usage {
+    size_t max_bytes;
+    int max_rank;
+    size_t total_bytes;
+    int num_stacks;
+    usage() : max_bytes(0), max_rank(-1), total_bytes(0), num_stacks(0) {}
+  };
+  /// High-water marks indexed by app id
+  static std::map<int,usage> usage_;
 
  public:
   static size_t stacksize() {
@@ -101,6 +130,26 @@ class StackAlloc
 
   static void free(void*);
 
+  /**
+   * @brief recordUsage If stacks are painted, find how deep the stack
+   *        was used before it is returned
+   * @param stack
+   * @param aid  The app the stack belonged to
+   * @param rank The rank within the app
+   */
+  static void recordUsage(void* stack, int aid, int rank);
+
+  /**
+   * @brief printUsage Report high-water marks for each app and the stack size
+   *        they suggest if stacks are painted, and reserved vs committed
+   *        stack memory if requested.
+   */
+  static void printUsage(std::ostream& os);
+
+  /**
+   * @brief clear Unmap all stacks and reset the allocator so init can
+   *        be called again. Every stack must already have been freed.
+   */
   static void clear();
 
 };
@@ -66,7 +66,11 @@ StackAlloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size, bool pro
   step_size_((protect_) ? 2 * stacksize_ : stacksize_)
 {
   // Now allocate our chunk.
+  // Only reserve address space, pages are committed when touched
   int mmap_flags = MAP_PRIVATE | MAP_ANON;
+#ifdef MAP_NORESERVE
+  mmap_flags |= MAP_NORESERVE;
+#endif
   addr_ = (char*)mmap(0, size_, PROT_READ | PROT_WRITE | PROT_EXEC,
                       mmap_flags, -1, 0);
   if(addr_ == MAP_FAILED) {
@@ -80,6 +80,14 @@ class StackAlloc::chunk
 
   void*  getNextStack();
 
+  char* addr() const {
+    return addr_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
 };
 
 }
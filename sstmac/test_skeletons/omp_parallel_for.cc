@@ -0,0 +1,85 @@
+/**
+Copyright 2009-2018 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2018, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/replacements/mpi.h>
+#include <sstmac/compute.h>
+#include <sprockit/keyword_registration.h>
+
+RegisterKeywords(
+ { "niter" , "the number of iterations in each parallel loop" },
+);
+
+#define sstmac_app_name test_omp_parallel_for
+
+static void
+parallel_for(const char* label, uint64_t niter, int schedule, uint64_t chunk, int nthread)
+{
+  double t_start = MPI_Wtime();
+  sstmac_omp_parallel_for(niter, schedule, chunk, niter*100, niter*20, 0, nthread);
+  double t_stop = MPI_Wtime();
+  ::printf("%-12s nthread=%d = %8.4fus\n", label, nthread, (t_stop-t_start)*1e6);
+}
+
+int USER_MAIN(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int me;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+
+  uint64_t niter = sstmac::getParam<int>("niter", 1000);
+
+  if (me == 0){
+    parallel_for("static", niter, SSTMAC_OMP_SCHED_STATIC, 0, 4);
+    parallel_for("static,64", niter, SSTMAC_OMP_SCHED_STATIC, 64, 4);
+    parallel_for("static", niter, SSTMAC_OMP_SCHED_STATIC, 0, 3);
+    parallel_for("static", niter, SSTMAC_OMP_SCHED_STATIC, 0, 16);
+    parallel_for("dynamic", niter, SSTMAC_OMP_SCHED_DYNAMIC, 0, 4);
+    parallel_for("dynamic,64", niter, SSTMAC_OMP_SCHED_DYNAMIC, 64, 4);
+    parallel_for("guided", niter, SSTMAC_OMP_SCHED_GUIDED, 0, 4);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
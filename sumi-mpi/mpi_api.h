@@ -784,7 +784,12 @@ class MpiApi : public sumi::SimTransport
 
   void addImmediateCollective(CollectiveOpBase::ptr&& op, MPI_Request* req);
 
-  bool test(MPI_Request *request, MPI_Status *status, int& tag, int& source);
+  /**
+   * @param progress Whether to block for test_delay if the request is incomplete.
+   *   Array tests pass false and make progress once per call, not once per request.
+   */
+  bool test(MPI_Request *request, MPI_Status *status, int& tag, int& source,
+            bool progress = true);
 
   int typeSize(MPI_Datatype type){
     int ret;
@@ -892,10 +897,15 @@ MpiApi* sstmac_mpi();
 
 }
 
-#define _start_mpi_call_(fxn) \
+#define _start_mpi_call_impl_(fxn, cheap) \
   SSTMACBacktrace(fxn); \
   sstmac::sw::FTQScope scope(activeThread(), mpi_tag); \
-  startAPICall()
+  startAPICall(cheap)
+
+#define _start_mpi_call_(fxn) _start_mpi_call_impl_(fxn, false)
+
+//for calls that neither communicate nor block
+#define _start_cheap_mpi_call_(fxn) _start_mpi_call_impl_(fxn, true)
 
 #if SSTMAC_COMM_SYNC_STATS
   #define start_mpi_call(fxn) \
@@ -202,7 +202,7 @@ MpiApi::sendInit(const void *buf, int count,
 {
   auto call_start_time = (uint64_t)now().usec();
 
-  _start_mpi_call_(MPI_Send_init);
+  _start_cheap_mpi_call_(MPI_Send_init);
 
   MpiRequest* req = MpiRequest::construct(MpiRequest::Send);
   addRequestPtr(req, request);
@@ -309,7 +309,7 @@ int
 MpiApi::recvInit(void *buf, int count, MPI_Datatype datatype, int source,
                    int tag, MPI_Comm comm, MPI_Request *request)
 {
-  _start_mpi_call_(MPI_Recv_init);
+  _start_cheap_mpi_call_(MPI_Recv_init);
 
   MpiRequest* req = MpiRequest::construct(MpiRequest::Recv);
   addRequestPtr(req, request);
@@ -51,9 +51,10 @@ Questions? Contact sst-macro-help@sandia.gov
 namespace sumi {
 
 bool
-MpiApi::test(MPI_Request *request, MPI_Status *status, int& tag, int& source)
+MpiApi::test(MPI_Request *request, MPI_Status *status, int& tag, int& source,
+             bool progress)
 {
-  _start_mpi_call_(MPI_Test);
+  _start_cheap_mpi_call_(MPI_Test);
   mpi_api_debug(sprockit::dbg::mpi | sprockit::dbg::mpi_request, "MPI_Test(...)");
 
   if (*request == MPI_REQUEST_NULL){
@@ -71,7 +72,7 @@ MpiApi::test(MPI_Request *request, MPI_Status *status, int& tag, int& source)
     *request = MPI_REQUEST_NULL;
     return true;
   } else {
-    if (test_delay_us_){
+    if (progress && test_delay_us_){
       queue_->forwardProgress(test_delay_us_*1e-6);
     }
     return false;
@@ -84,7 +85,7 @@ MpiApi::test(MPI_Request *request, int *flag, MPI_Status *status)
   MPI_Request req_cpy = *request;
   auto start_clock = traceClock();
   int tag, source;
-  _start_mpi_call_(MPI_Test);
+  _start_cheap_mpi_call_(MPI_Test);
   if (test(request, status, tag, source)){
     mpi_api_debug(sprockit::dbg::mpi | sprockit::dbg::mpi_request, "MPI_Test(...)");
     *flag = 1;
@@ -116,7 +117,7 @@ MpiApi::testall(int count, MPI_Request array_of_requests[], int *flag, MPI_Statu
   std::vector<dumpi::OTF2_Writer::mpi_status_t> statuses(count);
 #endif
 
-  _start_mpi_call_(MPI_Testall);
+  _start_cheap_mpi_call_(MPI_Testall);
   *flag = 1;
   bool ignore_status = array_of_statuses == MPI_STATUSES_IGNORE;
   for (int i=0; i < count; ++i){
@@ -157,7 +158,7 @@ MpiApi::testany(int count, MPI_Request array_of_requests[], int *indx, int *flag
   dumpi::OTF2_Writer::mpi_status_t stat;
 #endif
 
-  startAPICall();
+  startAPICall(true);
   if (count == 0){
     *flag = 1;
     return MPI_SUCCESS;
@@ -166,7 +167,7 @@ MpiApi::testany(int count, MPI_Request array_of_requests[], int *indx, int *flag
   *indx = MPI_UNDEFINED;
   for (int i=0; i < count; ++i){
     int tag, source;
-    if (test(&array_of_requests[i], status, tag, source)){
+    if (test(&array_of_requests[i], status, tag, source, false)){
       *flag = 1;
       *indx = i;
 #ifdef SSTMAC_OTF2_ENABLED
@@ -176,6 +177,9 @@ MpiApi::testany(int count, MPI_Request array_of_requests[], int *indx, int *flag
       break;
     }
   }
+  if (!*flag && test_delay_us_){
+    queue_->forwardProgress(test_delay_us_*1e-6);
+  }
   endAPICall();
 
 #ifdef SSTMAC_OTF2_ENABLED
@@ -199,13 +203,13 @@ MpiApi::testsome(int incount, MPI_Request array_of_requests[], int *outcount,
   std::vector<dumpi::OTF2_Writer::mpi_status_t> statuses(incount);
 #endif
 
-  startAPICall();
+  startAPICall(true);
   int numComplete = 0;
   bool ignore_status = array_of_statuses == MPI_STATUSES_IGNORE;
   for (int i=0; i < incount; ++i){
     MPI_Status* stat = ignore_status ? MPI_STATUS_IGNORE : &array_of_statuses[i];
     int tag, source;
-    if (test(&array_of_requests[i], stat, tag, source)){
+    if (test(&array_of_requests[i], stat, tag, source, false)){
       array_of_indices[numComplete++] = i;
 #ifdef SSTMAC_OTF2_ENABLED
       statuses[i].tag = tag;
@@ -213,6 +217,9 @@ MpiApi::testsome(int incount, MPI_Request array_of_requests[], int *outcount,
 #endif
     }
   }
+  if (numComplete == 0 && test_delay_us_){
+    queue_->forwardProgress(test_delay_us_*1e-6);
+  }
   *outcount = numComplete;
   endAPICall();
 
@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi-mpi/otf2_output_stat.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
+#include <algorithm>
 #include <cassert>
 
 namespace sumi {
@@ -162,81 +163,48 @@ MpiApi::waitany(int count, MPI_Request array_of_requests[], int *indx,
 {
   auto start_clock = traceClock();
 
-  // for caching the request in an upper scope before it is destroyed
-  MPI_Request req_val = -1;
-
   start_mpi_call(MPI_Waitany);
   mpi_api_debug(sprockit::dbg::mpi, "MPI_Waitany(...)");
   *indx = MPI_UNDEFINED;
-  std::vector<MpiRequest*> reqPtrs(count);
+  MpiRequestSet pending;
   int numNonnull = 0;
-  bool call_completed = false;
-  //use a null ptr internally to indicate ignore
+  int done = -1;
   for (int i=0; i < count; ++i){
     MPI_Request req = array_of_requests[i];
     if (req != MPI_REQUEST_NULL){
       MpiRequest* reqPtr = getRequest(req);
       if (reqPtr->isComplete()){
-#ifdef SSTMAC_OTF2_ENABLED
-        if (OTF2Writer_){
-          dumpi::OTF2_Writer::mpi_status_t stat;
-          stat.tag = reqPtr->status().MPI_TAG;
-          stat.source = reqPtr->status().MPI_SOURCE;
-          OTF2Writer_->writer().mpi_waitany(start_clock, traceClock(), req, &stat);
-        }
-#endif
-        *indx = i;
-        req_val = req;
-        finalizeWaitRequest(reqPtr, &array_of_requests[i], status);
-        finish_mpi_call(MPI_Waitany);
-
-        call_completed = true;
+        done = i;
         break;
-        //return MPI_SUCCESS;
       }
-      reqPtrs[numNonnull++] = reqPtr;
+      pending.add(reqPtr, i);
+      ++numNonnull;
     }
   }
 
-  if (!call_completed && numNonnull == 0){
-    spkt_abort_printf("MPI_Waitany: passed in all null requests, undefined behavior");
-    call_completed = true;
-  }
-
-  if(!call_completed) {
-    //none of them are already done
-    reqPtrs.resize(numNonnull);
-    queue_->startProgressLoop(reqPtrs);
-
-    numNonnull = 0;
-    for (int i=0; i < count; ++i){
-      MPI_Request req = array_of_requests[i];
-      if (req != MPI_REQUEST_NULL){
-        MpiRequest* reqPtr = reqPtrs[numNonnull++];
-        if (reqPtr->isComplete()){
-#ifdef SSTMAC_OTF2_ENABLED
-          if (OTF2Writer_){
-            dumpi::OTF2_Writer::mpi_status_t stat;
-            stat.tag = reqPtr->status().MPI_TAG;
-            stat.source = reqPtr->status().MPI_SOURCE;
-            OTF2Writer_->writer().mpi_waitany(start_clock, traceClock(), req, &stat);
-          }
-#endif
-          *indx = i;
-          req_val = req;
-          finalizeWaitRequest(reqPtr, &array_of_requests[i], status);
-          finish_mpi_call(MPI_Waitany);
-          call_completed = true;
-          break;
-        }
-      }
+  if (done < 0){
+    if (numNonnull == 0){
+      spkt_abort_printf("MPI_Waitany: passed in all null requests, undefined behavior");
     }
+    //none of them are already done
+    queue_->progressLoop(pending);
+    done = pending.completed().front();
   }
+  pending.release();
 
-  if(!call_completed){
-    spkt_throw_printf(sprockit::ValueError,
-                    "MPI_Waitany finished, but had no completed requests");
+  MPI_Request req = array_of_requests[done];
+  MpiRequest* reqPtr = getRequest(req);
+#ifdef SSTMAC_OTF2_ENABLED
+  if (OTF2Writer_){
+    dumpi::OTF2_Writer::mpi_status_t stat;
+    stat.tag = reqPtr->status().MPI_TAG;
+    stat.source = reqPtr->status().MPI_SOURCE;
+    OTF2Writer_->writer().mpi_waitany(start_clock, traceClock(), req, &stat);
   }
+#endif
+  *indx = done;
+  finalizeWaitRequest(reqPtr, &array_of_requests[done], status);
+  finish_mpi_call(MPI_Waitany);
 
   return MPI_SUCCESS;
 }
@@ -257,52 +225,42 @@ MpiApi::waitsome(int incount, MPI_Request array_of_requests[],
   mpi_api_debug(sprockit::dbg::mpi | sprockit::dbg::mpi_request, "MPI_Waitsome(...)");
   int numComplete = 0;
   int numIncomplete = 0;
-  std::vector<MpiRequest*> reqPtrs(incount);
+  MpiRequestSet pending;
   for (int i=0; i < incount; ++i){
     MPI_Request req = array_of_requests[i];
     if (req != MPI_REQUEST_NULL){
       MpiRequest* reqPtr = getRequest(req);
       if (reqPtr->isComplete()){
-#ifdef SSTMAC_OTF2_ENABLED
-        req_vect[i] = req;
-        statuses[i].tag = reqPtr->status().MPI_TAG;
-        statuses[i].source = reqPtr->status().MPI_SOURCE;
-#endif
         array_of_indices[numComplete++] = i;
-        finalizeWaitRequest(reqPtr, &array_of_requests[i],
-           ignore_status ? MPI_STATUS_IGNORE : &array_of_statuses[i]);
-      } else {
-        reqPtrs[numIncomplete++] = reqPtr;
+      } else if (numComplete == 0){
+        pending.add(reqPtr, i);
+        ++numIncomplete;
       }
     }
   }
 
-  if (numComplete > 0){
-    *outcount = numComplete;
-  } else {
-    reqPtrs.resize(numIncomplete);
-
-    queue_->startProgressLoop(reqPtrs);
+  if (numComplete == 0 && numIncomplete > 0){
+    queue_->progressLoop(pending);
+    //only the requests that completed are visited, not the whole array
+    for (int i : pending.completed()){
+      array_of_indices[numComplete++] = i;
+    }
+    std::sort(array_of_indices, array_of_indices + numComplete);
+  }
+  pending.release();
 
-    for (int i=0; i < incount; ++i){
-      MPI_Request req = array_of_requests[i];
-      if (req != MPI_REQUEST_NULL){
-        MpiRequest* reqPtr = getRequest(req);
-        if (reqPtr->isComplete()){
+  for (int c=0; c < numComplete; ++c){
+    int i = array_of_indices[c];
+    MpiRequest* reqPtr = getRequest(array_of_requests[i]);
 #ifdef SSTMAC_OTF2_ENABLED
-          req_vect[i] = req;
-          statuses[i].tag = reqPtr->status().MPI_TAG;
-          statuses[i].source = reqPtr->status().MPI_SOURCE;
+    statuses[i].tag = reqPtr->status().MPI_TAG;
+    statuses[i].source = reqPtr->status().MPI_SOURCE;
 #endif
-          array_of_indices[numComplete++] = i;
-          finalizeWaitRequest(reqPtr, &array_of_requests[i],
-             ignore_status ? MPI_STATUS_IGNORE : &array_of_statuses[i]);
-        }
-      }
-    }
-    *outcount = numComplete;
-    finish_mpi_call(MPI_Waitsome);
+    finalizeWaitRequest(reqPtr, &array_of_requests[i],
+       ignore_status ? MPI_STATUS_IGNORE : &array_of_statuses[i]);
   }
+  *outcount = numComplete == 0 ? MPI_UNDEFINED : numComplete;
+  finish_mpi_call(MPI_Waitsome);
 
 #ifdef SSTMAC_OTF2_ENABLED
   if (OTF2Writer_){
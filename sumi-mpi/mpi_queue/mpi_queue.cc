@@ -466,24 +466,11 @@ MpiQueue::progressLoop(MpiRequest* req)
   return api_->now();
 }
 
-bool
-MpiQueue::atLeastOneComplete(const std::vector<MpiRequest*>& req)
-{
-  mpi_queue_debug("checking if any of %d requests is done", (int)req.size());
-  for (int i=0; i < (int) req.size(); ++i) {
-    if (req[i] && req[i]->isComplete()) {
-      mpi_queue_debug("request is done");
-      return true;
-    }
-  }
-  return false;
-}
-
 void
-MpiQueue::startProgressLoop(const std::vector<MpiRequest*>& reqs)
+MpiQueue::progressLoop(const MpiRequestSet& reqs)
 {
   mpi_queue_debug("starting progress loop");
-  while (!atLeastOneComplete(reqs)) {
+  while (!reqs.anyComplete()) {
     mpi_queue_debug("blocking on progress loop");
     sumi::Message* msg = queue_.find_any();
     if (!msg){
@@ -502,19 +489,6 @@ MpiQueue::forwardProgress(double timeout)
   if (msg) incomingMessage(msg);
 }
 
-void
-MpiQueue::startProgressLoop(
-  const std::vector<MpiRequest*>& req,
-  sstmac::Timestamp timeout)
-{
-  startProgressLoop(req);
-}
-
-void
-MpiQueue::finishProgressLoop(const std::vector<MpiRequest*>& req)
-{
-}
-
 void
 MpiQueue::memcopy(uint64_t bytes)
 {
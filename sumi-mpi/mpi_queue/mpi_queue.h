@@ -122,12 +122,11 @@ class MpiQueue
 
   void nonblockingProgress();
 
-  void startProgressLoop(const std::vector<MpiRequest*>& req);
-
-  void startProgressLoop(const std::vector<MpiRequest*>& req,
-                      sstmac::Timestamp timeout);
-
-  void finishProgressLoop(const std::vector<MpiRequest*>& req);
+  /**
+   * Block until at least one request registered with the set completes.
+   * Completions are pushed to the set, so no request is ever rescanned.
+   */
+  void progressLoop(const MpiRequestSet& reqs);
 
   void forwardProgress(double timeout);
 
@@ -178,8 +177,6 @@ class MpiQueue
 
   void clearPending();
 
-  bool atLeastOneComplete(const std::vector<MpiRequest*>& req);
-
  private:
   /// The sequence number for our next outbound transmission.
   std::unordered_map<TaskId, int> next_outbound_;
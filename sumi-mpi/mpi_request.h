@@ -51,10 +51,13 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi-mpi/mpi_message.h>
 #include <sumi-mpi/mpi_comm/mpi_comm_fwd.h>
 #include <sstmac/common/sstmac_config.h>
+#include <vector>
 
 
 namespace sumi {
 
+class MpiRequestSet;
+
 /**
  * Persistent send operations (send, bsend, rsend, ssend)
  */
@@ -161,7 +164,9 @@ class MpiRequest :
    cancelled_(false),
    optype_(ty),
    persistent_op_(nullptr),
-   collective_op_(nullptr)
+   collective_op_(nullptr),
+   waiter_(nullptr),
+   waiter_index_(0)
   {
   }
 
@@ -188,9 +193,7 @@ class MpiRequest :
     complete();
   }
 
-  void complete() {
-    complete_ = true;
-  }
+  inline void complete();
 
   void setComplete(bool flag){
     complete_ = flag;
@@ -233,6 +236,15 @@ class MpiRequest :
     return optype_;
   }
 
+  /**
+   * Register the wait this request belongs to, notified on completion
+   * @param index The position of this request in the wait's request array
+   */
+  void setWaiter(MpiRequestSet* set, int index){
+    waiter_ = set;
+    waiter_index_ = index;
+  }
+
  private:
   MPI_Status stat_;
   bool complete_;
@@ -242,8 +254,73 @@ class MpiRequest :
   PersistentOp* persistent_op_;
   CollectiveOpBase::ptr collective_op_;
 
+  MpiRequestSet* waiter_;
+  int waiter_index_;
+
+};
+
+/**
+ * Completion counter for a wait on an array of requests.
+ * Registered requests push their array index here as they complete,
+ * so a wake-up costs O(completed) rather than a rescan of every request.
+ * MPI forbids concurrent waits on the same request, so each request
+ * belongs to at most one set at a time.
+ */
+class MpiRequestSet
+{
+ public:
+  MpiRequestSet(){}
+
+  ~MpiRequestSet(){
+    release();
+  }
+
+  MpiRequestSet(const MpiRequestSet&) = delete;
+  MpiRequestSet& operator=(const MpiRequestSet&) = delete;
+
+  void add(MpiRequest* req, int index){
+    reqs_.push_back(req);
+    req->setWaiter(this, index);
+  }
+
+  void notify(int index){
+    completed_.push_back(index);
+  }
+
+  bool anyComplete() const {
+    return !completed_.empty();
+  }
+
+  /** @return Array indices of registered requests, in completion order */
+  const std::vector<int>& completed() const {
+    return completed_;
+  }
+
+  /**
+   * Unregister all requests. Must be called before any registered
+   * request is freed.
+   */
+  void release(){
+    for (MpiRequest* req : reqs_){
+      req->setWaiter(nullptr, 0);
+    }
+    reqs_.clear();
+  }
+
+ private:
+  std::vector<MpiRequest*> reqs_;
+  std::vector<int> completed_;
 };
 
+void
+MpiRequest::complete()
+{
+  if (!complete_ && waiter_){
+    waiter_->notify(waiter_index_);
+  }
+  complete_ = true;
+}
+
 }
 
 #endif
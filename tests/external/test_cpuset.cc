@@ -44,6 +44,8 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sched.h>
 #include <pthread.h>
+#include <stdio.h>
+#include <vector>
 
 void*
 pthread_run(void* args){
@@ -54,6 +56,57 @@ pthread_run(void* args){
   return 0;
 }
 
+static void
+runPinned(int first_id, int nthread, cpu_set_t* sets)
+{
+  std::vector<pthread_attr_t> attrs(nthread);
+  std::vector<pthread_t> threads(nthread);
+  std::vector<int> thread_ids(nthread);
+  for (int i=0; i < nthread; ++i){
+    pthread_attr_init(&attrs[i]);
+    pthread_attr_setaffinity_np(&attrs[i], sizeof(cpu_set_t), &sets[i]);
+    thread_ids[i] = first_id + i;
+    pthread_create(&threads[i], &attrs[i], pthread_run, &thread_ids[i]);
+  }
+  void* args = 0;
+  for (int i=0; i < nthread; ++i){
+    pthread_join(threads[i], &args);
+  }
+}
+
+/**
+ * Masks on cores past the first 64-bit word of the set:
+ * three threads share cores 63 and 64, two share core 150 after
+ * 64-191 are set and all but 150 cleared, and one runs alone on 255
+ */
+static void
+manycore(int first_id)
+{
+  const int nthread = 6;
+  cpu_set_t sets[nthread];
+  for (int i=0; i < nthread; ++i){
+    CPU_ZERO(&sets[i]);
+  }
+  for (int i=0; i < 3; ++i){
+    CPU_SET(63, &sets[i]);
+    CPU_SET(64, &sets[i]);
+  }
+  for (int i=3; i < 5; ++i){
+    for (int c=64; c < 192; ++c) CPU_SET(c, &sets[i]);
+    for (int c=64; c < 192; ++c){
+      if (c != 150) CPU_CLR(c, &sets[i]);
+    }
+  }
+  CPU_SET(255, &sets[5]);
+
+  for (int i=0; i < nthread; ++i){
+    printf("Thread %d has %d cores in its mask, core 64 %s\n",
+           first_id + i, CPU_COUNT(&sets[i]),
+           CPU_ISSET(64, &sets[i]) ? "set" : "clear");
+  }
+  runPinned(first_id, nthread, sets);
+}
+
 #define sstmac_app_name user_app_cxx
 
 int USER_MAIN(int argc, char** argv)
@@ -91,5 +144,9 @@ int USER_MAIN(int argc, char** argv)
     pthread_join(threads[i], &args);
   }
 
+  if (argc > 1){
+    manycore(nthread + 1);
+  }
+
   return 0;
 }
@@ -0,0 +1,83 @@
+/**
+Copyright 2009-2018 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2018, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeleton.h>
+#include <sstmac/compute.h>
+#include <sstmac/software/process/memoize.h>
+#include <sstmac/software/process/memoize_db.h>
+#include <iostream>
+#include <cstdlib>
+
+extern "C" int ubuntu_cant_name_mangle() { return 0; }
+
+static sstmac::Memoization memoize_loop("loop","linear");
+
+#define sstmac_app_name test_memoize
+
+int USER_MAIN(int argc, char** argv)
+{
+  uint64_t loaded = 0;
+  auto* data = sstmac::sw::MemoizeDatabase::find("loop");
+  if (data){
+    for (auto& entry : data->entries){
+      loaded += entry.second.count;
+    }
+  }
+  std::cout << "Loaded " << loaded << " samples" << std::endl;
+
+  //regions at parameters the database already has are not recorded again
+  int max_n = argc > 1 ? atoi(argv[1]) : 4;
+  int recorded = 0;
+  volatile double sum = 0;
+  for (int n=1; n <= max_n; ++n){
+    double param = n;
+    if (!sstmac::sw::MemoizeDatabase::contains("loop", 1, &param)) ++recorded;
+    int tag = sstmac_startMemoize("loop","linear");
+    for (int i=0; i < 1000*n; ++i) sum += i;
+    sstmac_finish_memoize1(tag,"loop",n);
+  }
+  std::cout << "Recorded " << recorded << " new regions" << std::endl;
+
+  return 0;
+}
@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/libraries/pthread/sstmac_pthread.h>
 #include <sstmac/skeleton.h>
 #include <sstmac/compute.h>
+#include <errno.h>
 
 using namespace sstmac;
 using namespace sstmac::sw;
@@ -100,6 +101,7 @@ void* ptest2(void* args)
     sprockit::abort("thread failed wait");
   }
   std::cout << "Done waiting" << std::endl;
+  pthread_mutex_unlock(&pargs->mutex);
   SSTMAC_compute(0.001);
 
   return 0;
@@ -137,6 +139,21 @@ int USER_MAIN(int argc, char** argv)
     pthread_join(thr1, &ret);
     pthread_join(thr2, &ret);
 
+    status = pthread_create(&thr1, nullptr, &ptest2, &pargs);
+    status = pthread_create(&thr2, nullptr, &ptest2, &pargs);
+    SSTMAC_compute(1);
+    if (pthread_mutex_trylock(&pargs.mutex) != 0){
+      sprockit::abort("trylock failed on free mutex");
+    }
+    if (pthread_mutex_trylock(&pargs.mutex) != EBUSY){
+      sprockit::abort("trylock succeeded on held mutex");
+    }
+    std::cout << "Broadcast" << std::endl;
+    pthread_cond_broadcast(&pargs.cond);
+    pthread_mutex_unlock(&pargs.mutex);
+    pthread_join(thr1, &ret);
+    pthread_join(thr2, &ret);
+
     //spin off another pthread
     status = pthread_create(&thr1, nullptr, &ptest, &pargs);
 